@@ -0,0 +1,132 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+std::atomic<bool>             g_IsEnabled{false};
+std::atomic<Diligent::Uint64> g_TotalAllocations{0};
+thread_local Diligent::Uint64 t_ThreadAllocations = 0;
+thread_local bool             t_IsExcluded        = false;
+
+void* CountedAlloc(size_t Size)
+{
+    if (g_IsEnabled.load(std::memory_order_relaxed))
+    {
+        if (!t_IsExcluded)
+            g_TotalAllocations.fetch_add(1, std::memory_order_relaxed);
+        ++t_ThreadAllocations;
+    }
+    return std::malloc(Size != 0 ? Size : 1);
+}
+
+} // namespace
+
+void* operator new(size_t Size)
+{
+    if (void* Ptr = CountedAlloc(Size))
+        return Ptr;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](size_t Size)
+{
+    if (void* Ptr = CountedAlloc(Size))
+        return Ptr;
+    throw std::bad_alloc{};
+}
+
+void* operator new(size_t Size, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(Size);
+}
+
+void* operator new[](size_t Size, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(Size);
+}
+
+void operator delete(void* Ptr) noexcept
+{
+    std::free(Ptr);
+}
+
+void operator delete[](void* Ptr) noexcept
+{
+    std::free(Ptr);
+}
+
+void operator delete(void* Ptr, size_t) noexcept
+{
+    std::free(Ptr);
+}
+
+void operator delete[](void* Ptr, size_t) noexcept
+{
+    std::free(Ptr);
+}
+
+void operator delete(void* Ptr, const std::nothrow_t&) noexcept
+{
+    std::free(Ptr);
+}
+
+void operator delete[](void* Ptr, const std::nothrow_t&) noexcept
+{
+    std::free(Ptr);
+}
+
+namespace Diligent
+{
+
+namespace AllocationCounter
+{
+
+void Enable()
+{
+    g_IsEnabled.store(true, std::memory_order_relaxed);
+}
+
+bool IsEnabled()
+{
+    return g_IsEnabled.load(std::memory_order_relaxed);
+}
+
+Uint64 GetTotalCount()
+{
+    return g_TotalAllocations.load(std::memory_order_relaxed);
+}
+
+Uint64 GetThreadCount()
+{
+    return t_ThreadAllocations;
+}
+
+void ExcludeCurrentThread()
+{
+    t_IsExcluded = true;
+}
+
+} // namespace AllocationCounter
+
+} // namespace Diligent
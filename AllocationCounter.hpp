@@ -0,0 +1,60 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Counters maintained by the replacement global operator new (see AllocationCounter.cpp).
+/// Linking AllocationCounter.cpp into a target replaces the global allocation functions
+/// for the whole executable. Over-aligned allocations are not counted.
+/// Counting is disabled by default, so that the allocation functions only add a relaxed
+/// atomic load to malloc/free until Enable() is called.
+namespace AllocationCounter
+{
+
+/// Starts counting allocations of all threads.
+void Enable();
+
+bool IsEnabled();
+
+/// Total number of global heap allocations made by all threads except the excluded ones.
+Uint64 GetTotalCount();
+
+/// Number of global heap allocations made by the calling thread.
+Uint64 GetThreadCount();
+
+/// Stops adding allocations of the calling thread to the total count. Used for threads
+/// whose allocations are expected, such as the frame encoder workers.
+void ExcludeCurrentThread();
+
+} // namespace AllocationCounter
+
+} // namespace Diligent
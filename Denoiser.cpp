@@ -0,0 +1,390 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Denoiser.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "DebugUtilities.hpp"
+#include "WorkerPool.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define DILIGENT_DENOISER_SSE 1
+#    include <emmintrin.h>
+#else
+#    define DILIGENT_DENOISER_SSE 0
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+// B3-spline kernel
+constexpr float KernelWeights[5] = {1.f / 16.f, 1.f / 4.f, 3.f / 8.f, 1.f / 4.f, 1.f / 16.f};
+
+inline float Luminance(const float* pRGBA)
+{
+    return 0.2126f * pRGBA[0] + 0.7152f * pRGBA[1] + 0.0722f * pRGBA[2];
+}
+
+inline float Dot3(const float* a, const float* b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+struct PassAttribs
+{
+    Uint32 Width;
+    Uint32 Height;
+    int    Step;
+    float  InvColorSigma;
+    float  DepthSigma;
+    float  NormalPower;
+
+    const float* pSrc;
+    const float* pDepth;
+    const float* pNormals;
+    float*       pDst;
+
+    // Planar copies used by the vectorized path: luminance of pSrc and normal components.
+    const float* pLum;
+    const float* pNormalX;
+    const float* pNormalY;
+    const float* pNormalZ;
+};
+
+void FilterPixel(const PassAttribs& Pass, int x, int y)
+{
+    const int W = static_cast<int>(Pass.Width);
+    const int H = static_cast<int>(Pass.Height);
+
+    const size_t Center  = static_cast<size_t>(y) * W + x;
+    const float* pColorP = Pass.pSrc + Center * 4;
+    const float* pNormP  = Pass.pNormals + Center * 4;
+    const float  DepthP  = Pass.pDepth[Center];
+    const float  LumP    = Luminance(pColorP);
+
+    // Scale the depth tolerance with distance and tap spacing so that
+    // slanted surfaces are not treated as edges.
+    const float InvDepthSigma = 1.f / (Pass.DepthSigma * std::abs(DepthP) * static_cast<float>(Pass.Step) + 1e-6f);
+
+    float Sum[4]    = {};
+    float WeightSum = 0;
+
+    for (int ky = 0; ky < 5; ++ky)
+    {
+        const int qy = y + (ky - 2) * Pass.Step;
+        if (qy < 0 || qy >= H)
+            continue;
+
+        for (int kx = 0; kx < 5; ++kx)
+        {
+            const int qx = x + (kx - 2) * Pass.Step;
+            if (qx < 0 || qx >= W)
+                continue;
+
+            const size_t Tap     = static_cast<size_t>(qy) * W + qx;
+            const float* pColorQ = Pass.pSrc + Tap * 4;
+
+            const float NdotN = Dot3(pNormP, Pass.pNormals + Tap * 4);
+            if (NdotN <= 0)
+                continue;
+
+            // All edge-stopping functions are combined into a single exp():
+            // NdotN^NormalPower * exp(-DepthTerm) * exp(-LumTerm)
+            const float NormalTerm = Pass.NormalPower * std::log(NdotN);
+            const float DepthTerm  = std::abs(DepthP - Pass.pDepth[Tap]) * InvDepthSigma;
+            const float LumTerm    = std::abs(LumP - Luminance(pColorQ)) * Pass.InvColorSigma;
+
+            const float Weight = KernelWeights[kx] * KernelWeights[ky] * std::exp(NormalTerm - DepthTerm - LumTerm);
+            for (int c = 0; c < 4; ++c)
+                Sum[c] += pColorQ[c] * Weight;
+            WeightSum += Weight;
+        }
+    }
+
+    // The center tap always has a non-zero weight unless the normal is degenerate.
+    float* pDst = Pass.pDst + Center * 4;
+    if (WeightSum > 0)
+    {
+        const float InvWeightSum = 1.f / WeightSum;
+        for (int c = 0; c < 4; ++c)
+            pDst[c] = Sum[c] * InvWeightSum;
+    }
+    else
+    {
+        std::copy(pColorP, pColorP + 4, pDst);
+    }
+}
+
+#if DILIGENT_DENOISER_SSE
+
+// Polynomial approximations of log2() and exp2() for four floats at a time. The relative
+// error of the resulting weights is below 1e-4, which is far below what the filter can show.
+
+inline __m128 Log2x4(__m128 x)
+{
+    x = _mm_max_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x00800000))); // Smallest normal
+
+    const __m128i Bits     = _mm_castps_si128(x);
+    const __m128  Exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(Bits, 23), _mm_set1_epi32(127)));
+    // Mantissa in [1, 2)
+    const __m128 m = _mm_or_ps(_mm_castsi128_ps(_mm_and_si128(Bits, _mm_set1_epi32(0x007FFFFF))), _mm_set1_ps(1.f));
+
+    __m128 p = _mm_set1_ps(0.0596515482674574969533f);
+    p        = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(-0.465725644288844778798f));
+    p        = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(1.48116647521213171641f));
+    p        = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(-2.52074962577807006663f));
+    p        = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(2.8882704548164776201f));
+
+    return _mm_add_ps(_mm_mul_ps(p, _mm_sub_ps(m, _mm_set1_ps(1.f))), Exponent);
+}
+
+inline __m128 Exp2x4(__m128 x)
+{
+    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-126.f)), _mm_set1_ps(126.f));
+
+    // 2^x = 2^i * 2^f, i = floor(x), f in [0, 1)
+    __m128i i = _mm_cvttps_epi32(x);
+    // Truncation rounds negative numbers up: subtract 1 (add the all-ones mask) where it did.
+    i              = _mm_add_epi32(i, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(i), x)));
+    const __m128 f = _mm_sub_ps(x, _mm_cvtepi32_ps(i));
+
+    __m128 p = _mm_set1_ps(1.8775767e-3f);
+    p        = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(8.9893397e-3f));
+    p        = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(5.5826318e-2f));
+    p        = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(2.4015361e-1f));
+    p        = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(6.9315308e-1f));
+    p        = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(9.9999994e-1f));
+
+    return _mm_mul_ps(p, _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(i, _mm_set1_epi32(127)), 23)));
+}
+
+inline __m128 Abs4(__m128 x)
+{
+    return _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)));
+}
+
+// Filters pixels x..x+3 of row y. All horizontal taps must be inside the image.
+// The weights of the four pixels are computed together from the planar luminance and
+// normals, so every tap costs one vector log2() and exp2() instead of four scalar log() and exp().
+void FilterQuad(const PassAttribs& Pass, int x, int y)
+{
+    const int W = static_cast<int>(Pass.Width);
+    const int H = static_cast<int>(Pass.Height);
+
+    const size_t Center = static_cast<size_t>(y) * W + x;
+
+    const __m128 NormPx = _mm_loadu_ps(Pass.pNormalX + Center);
+    const __m128 NormPy = _mm_loadu_ps(Pass.pNormalY + Center);
+    const __m128 NormPz = _mm_loadu_ps(Pass.pNormalZ + Center);
+    const __m128 DepthP = _mm_loadu_ps(Pass.pDepth + Center);
+    const __m128 LumP   = _mm_loadu_ps(Pass.pLum + Center);
+
+    // The weight is computed as exp2(), so the depth and luminance terms are scaled by log2(e).
+    constexpr float Log2E = 1.44269504f;
+
+    const __m128 InvDepthSigma = _mm_div_ps(_mm_set1_ps(Log2E),
+                                            _mm_add_ps(_mm_mul_ps(Abs4(DepthP), _mm_set1_ps(Pass.DepthSigma * static_cast<float>(Pass.Step))),
+                                                       _mm_set1_ps(1e-6f)));
+    const __m128 InvColorSigma = _mm_set1_ps(Pass.InvColorSigma * Log2E);
+    const __m128 NormalPower   = _mm_set1_ps(Pass.NormalPower);
+
+    // Sum[i] accumulates the RGBA color of pixel x + i.
+    __m128 Sum[4]    = {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+    __m128 WeightSum = _mm_setzero_ps();
+
+    for (int ky = 0; ky < 5; ++ky)
+    {
+        const int qy = y + (ky - 2) * Pass.Step;
+        if (qy < 0 || qy >= H)
+            continue;
+
+        for (int kx = 0; kx < 5; ++kx)
+        {
+            const size_t Tap = static_cast<size_t>(qy) * W + x + (kx - 2) * Pass.Step;
+
+            const __m128 NdotN = _mm_add_ps(_mm_add_ps(_mm_mul_ps(NormPx, _mm_loadu_ps(Pass.pNormalX + Tap)),
+                                                       _mm_mul_ps(NormPy, _mm_loadu_ps(Pass.pNormalY + Tap))),
+                                            _mm_mul_ps(NormPz, _mm_loadu_ps(Pass.pNormalZ + Tap)));
+
+            const __m128 NormalTerm = _mm_mul_ps(NormalPower, Log2x4(NdotN));
+            const __m128 DepthTerm  = _mm_mul_ps(Abs4(_mm_sub_ps(DepthP, _mm_loadu_ps(Pass.pDepth + Tap))), InvDepthSigma);
+            const __m128 LumTerm    = _mm_mul_ps(Abs4(_mm_sub_ps(LumP, _mm_loadu_ps(Pass.pLum + Tap))), InvColorSigma);
+
+            __m128 Weight = Exp2x4(_mm_sub_ps(_mm_sub_ps(NormalTerm, DepthTerm), LumTerm));
+            Weight        = _mm_mul_ps(Weight, _mm_set1_ps(KernelWeights[kx] * KernelWeights[ky]));
+            // Taps facing away from the pixel are ignored.
+            Weight    = _mm_and_ps(Weight, _mm_cmpgt_ps(NdotN, _mm_setzero_ps()));
+            WeightSum = _mm_add_ps(WeightSum, Weight);
+
+            const float* pColorQ = Pass.pSrc + Tap * 4;
+            Sum[0]               = _mm_add_ps(Sum[0], _mm_mul_ps(_mm_loadu_ps(pColorQ + 0), _mm_shuffle_ps(Weight, Weight, _MM_SHUFFLE(0, 0, 0, 0))));
+            Sum[1]               = _mm_add_ps(Sum[1], _mm_mul_ps(_mm_loadu_ps(pColorQ + 4), _mm_shuffle_ps(Weight, Weight, _MM_SHUFFLE(1, 1, 1, 1))));
+            Sum[2]               = _mm_add_ps(Sum[2], _mm_mul_ps(_mm_loadu_ps(pColorQ + 8), _mm_shuffle_ps(Weight, Weight, _MM_SHUFFLE(2, 2, 2, 2))));
+            Sum[3]               = _mm_add_ps(Sum[3], _mm_mul_ps(_mm_loadu_ps(pColorQ + 12), _mm_shuffle_ps(Weight, Weight, _MM_SHUFFLE(3, 3, 3, 3))));
+        }
+    }
+
+    // The center tap always has a non-zero weight unless the normal is degenerate,
+    // in which case the pixel keeps its color.
+    alignas(16) float WeightSums[4];
+    _mm_store_ps(WeightSums, WeightSum);
+    for (int i = 0; i < 4; ++i)
+    {
+        float* pDst = Pass.pDst + (Center + i) * 4;
+        if (WeightSums[i] > 0)
+            _mm_storeu_ps(pDst, _mm_mul_ps(Sum[i], _mm_set1_ps(1.f / WeightSums[i])));
+        else
+            std::copy(Pass.pSrc + (Center + i) * 4, Pass.pSrc + (Center + i) * 4 + 4, pDst);
+    }
+}
+
+#endif
+
+void FilterRows(const PassAttribs& Pass, Uint32 FirstRow, Uint32 EndRow)
+{
+    const int W = static_cast<int>(Pass.Width);
+
+    for (int y = static_cast<int>(FirstRow); y < static_cast<int>(EndRow); ++y)
+    {
+        int x = 0;
+#if DILIGENT_DENOISER_SSE
+        // Pixels whose taps may fall outside the image on the left or right use the scalar path.
+        const int FirstInner = std::min(2 * Pass.Step, W);
+        const int EndInner   = W - 2 * Pass.Step;
+        for (; x < FirstInner; ++x)
+            FilterPixel(Pass, x, y);
+        for (; x + 4 <= EndInner; x += 4)
+            FilterQuad(Pass, x, y);
+#endif
+        for (; x < W; ++x)
+            FilterPixel(Pass, x, y);
+    }
+}
+
+} // namespace
+
+void DenoiseATrous(const DenoiseAttribs& Attribs, std::vector<float>& Scratch)
+{
+    VERIFY_EXPR(Attribs.pColor != nullptr && Attribs.pDepth != nullptr && Attribs.pNormals != nullptr && Attribs.pOutput != nullptr);
+    VERIFY(Attribs.pColor != Attribs.pOutput, "Input and output must not alias");
+
+    const size_t NumFloats = size_t{Attribs.Width} * Attribs.Height * 4;
+    if (NumFloats == 0)
+        return;
+
+    if (Attribs.NumPasses == 0)
+    {
+        std::copy(Attribs.pColor, Attribs.pColor + NumFloats, Attribs.pOutput);
+        return;
+    }
+
+    const size_t NumPixels = size_t{Attribs.Width} * Attribs.Height;
+
+    // Scratch holds the ping-pong color buffer followed by the planar luminance and normals.
+    Scratch.resize(NumFloats + NumPixels * 4);
+
+    WorkerPool& Pool = WorkerPool::GetDefault();
+
+    // Ping-pong between the output and scratch buffers so that the last pass writes to the output.
+    float* pBuffers[2] = {Attribs.pOutput, Scratch.data()};
+    int    DstIdx      = (Attribs.NumPasses % 2 == 1) ? 0 : 1;
+
+    float* const pLum     = Scratch.data() + NumFloats;
+    float* const pNormalX = pLum + NumPixels;
+    float* const pNormalY = pNormalX + NumPixels;
+    float* const pNormalZ = pNormalY + NumPixels;
+
+    PassAttribs Pass;
+    Pass.Width       = Attribs.Width;
+    Pass.Height      = Attribs.Height;
+    Pass.DepthSigma  = Attribs.DepthSigma;
+    Pass.NormalPower = Attribs.NormalPower;
+    Pass.pDepth      = Attribs.pDepth;
+    Pass.pNormals    = Attribs.pNormals;
+    Pass.pSrc        = Attribs.pColor;
+    Pass.pLum        = pLum;
+    Pass.pNormalX    = pNormalX;
+    Pass.pNormalY    = pNormalY;
+    Pass.pNormalZ    = pNormalZ;
+
+    // Splits rows among the threads so that each thread processes a contiguous range.
+    auto ForEachRowRange = [&](const auto& Fn) {
+        Pool.ParallelFor(Attribs.Height, Fn, Attribs.NumThreads);
+    };
+
+#if DILIGENT_DENOISER_SSE
+    ForEachRowRange([&](Uint32 FirstRow, Uint32 EndRow) {
+        for (size_t i = size_t{FirstRow} * Attribs.Width; i < size_t{EndRow} * Attribs.Width; ++i)
+        {
+            pNormalX[i] = Attribs.pNormals[i * 4 + 0];
+            pNormalY[i] = Attribs.pNormals[i * 4 + 1];
+            pNormalZ[i] = Attribs.pNormals[i * 4 + 2];
+        }
+    });
+#endif
+
+    float ColorSigma = Attribs.ColorSigma;
+    for (Uint32 PassIdx = 0; PassIdx < Attribs.NumPasses; ++PassIdx)
+    {
+        Pass.Step          = 1 << PassIdx;
+        Pass.InvColorSigma = 1.f / std::max(ColorSigma, 1e-6f);
+        Pass.pDst          = pBuffers[DstIdx];
+
+#if DILIGENT_DENOISER_SSE
+        ForEachRowRange([&](Uint32 FirstRow, Uint32 EndRow) {
+            for (size_t i = size_t{FirstRow} * Attribs.Width; i < size_t{EndRow} * Attribs.Width; ++i)
+                pLum[i] = Luminance(Pass.pSrc + i * 4);
+        });
+#endif
+
+        ForEachRowRange([&Pass](Uint32 FirstRow, Uint32 EndRow) {
+            FilterRows(Pass, FirstRow, EndRow);
+        });
+
+        Pass.pSrc = Pass.pDst;
+        DstIdx    = 1 - DstIdx;
+        ColorSigma *= 0.5f;
+    }
+    VERIFY_EXPR(Pass.pSrc == Attribs.pOutput);
+}
+
+double ComputePSNR(const float* pImage, const float* pReference, size_t NumValues, float PeakValue)
+{
+    VERIFY_EXPR(NumValues > 0 && PeakValue > 0);
+
+    double SquaredErrorSum = 0;
+    for (size_t i = 0; i < NumValues; ++i)
+    {
+        const double Diff = static_cast<double>(std::clamp(pImage[i], 0.f, PeakValue)) -
+            static_cast<double>(std::clamp(pReference[i], 0.f, PeakValue));
+        SquaredErrorSum += Diff * Diff;
+    }
+
+    const double MSE = SquaredErrorSum / static_cast<double>(NumValues);
+    if (MSE == 0)
+        return std::numeric_limits<double>::infinity();
+
+    return 10.0 * std::log10(static_cast<double>(PeakValue) * PeakValue / MSE);
+}
+
+} // namespace Diligent
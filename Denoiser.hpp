@@ -0,0 +1,85 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Edge-aware a-trous wavelet filter (Dammertz et al. 2010, "Edge-Avoiding A-Trous
+/// Wavelet Transform for fast Global Illumination Filtering") guided by depth and normals.
+///
+/// All images are tightly packed, row-major, Width * Height pixels.
+struct DenoiseAttribs
+{
+    Uint32 Width  = 0;
+    Uint32 Height = 0;
+
+    /// Noisy input color, 4 floats (RGBA) per pixel.
+    const float* pColor = nullptr;
+
+    /// Linear view depth, 1 float per pixel.
+    const float* pDepth = nullptr;
+
+    /// World-space normals, 4 floats (XYZ, W is ignored) per pixel.
+    const float* pNormals = nullptr;
+
+    /// Filtered output color, 4 floats per pixel. May not alias pColor.
+    float* pOutput = nullptr;
+
+    /// Number of filter passes. Pass i uses a tap spacing of 2^i pixels,
+    /// so 5 passes cover a 125x125 pixel footprint.
+    Uint32 NumPasses = 5;
+
+    /// Luminance edge-stopping sigma. It is halved after every pass.
+    float ColorSigma = 0.5f;
+
+    /// Relative depth edge-stopping sigma, scaled by the tap spacing.
+    float DepthSigma = 0.05f;
+
+    /// Exponent of the normal similarity weight max(0, dot(n, n'))^NormalPower.
+    float NormalPower = 64.f;
+
+    /// Maximum number of threads of the default WorkerPool to use; 0 means all of them.
+    Uint32 NumThreads = 0;
+};
+
+/// Filters the image on the default WorkerPool. Scratch holds the intermediate ping-pong
+/// buffer and planar copies of the guide data; it may be reused between calls to avoid allocations.
+void DenoiseATrous(const DenoiseAttribs& Attribs, std::vector<float>& Scratch);
+
+/// Returns the peak signal-to-noise ratio in dB between two images with NumValues
+/// floats each. Values are clamped to [0, PeakValue] before comparison.
+/// Returns +infinity for identical images.
+double ComputePSNR(const float* pImage, const float* pReference, size_t NumValues, float PeakValue = 1.f);
+
+} // namespace Diligent
@@ -0,0 +1,91 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "FrameArena.hpp"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+
+namespace Diligent
+{
+
+FrameArena::FrameArena(size_t InitialCapacity) :
+    m_pData{new Uint8[InitialCapacity]},
+    m_Capacity{InitialCapacity}
+{
+}
+
+void* FrameArena::Allocate(size_t Size, size_t Alignment)
+{
+    VERIFY((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+    const uintptr_t Base    = reinterpret_cast<uintptr_t>(m_pData.get());
+    const uintptr_t Aligned = (Base + m_Offset + Alignment - 1) & ~(uintptr_t{Alignment} - 1);
+    const size_t    Offset  = static_cast<size_t>(Aligned - Base);
+    if (Offset + Size <= m_Capacity)
+    {
+        m_Offset = Offset + Size;
+        return m_pData.get() + Offset;
+    }
+
+    // Out of space: serve the request from a dedicated block until the next Reset().
+    m_OverflowBlocks.emplace_back(new Uint8[Size + Alignment]);
+    m_OverflowSize += Size + Alignment;
+
+    const uintptr_t BlockBase = reinterpret_cast<uintptr_t>(m_OverflowBlocks.back().get());
+    return reinterpret_cast<void*>((BlockBase + Alignment - 1) & ~(uintptr_t{Alignment} - 1));
+}
+
+const char* FrameArena::Format(const char* Fmt, ...)
+{
+    va_list Args;
+    va_start(Args, Fmt);
+    va_list ArgsCopy;
+    va_copy(ArgsCopy, Args);
+    const int Len = std::vsnprintf(nullptr, 0, Fmt, ArgsCopy);
+    va_end(ArgsCopy);
+
+    if (Len < 0)
+    {
+        va_end(Args);
+        UNEXPECTED("Invalid format string");
+        return "";
+    }
+
+    char* Str = static_cast<char*>(Allocate(static_cast<size_t>(Len) + 1, 1));
+    std::vsnprintf(Str, static_cast<size_t>(Len) + 1, Fmt, Args);
+    va_end(Args);
+    return Str;
+}
+
+void FrameArena::Reset()
+{
+    if (!m_OverflowBlocks.empty())
+    {
+        // Grow to fit the whole frame next time.
+        const size_t NewCapacity = std::max(m_Capacity * 2, m_Offset + m_OverflowSize);
+        m_pData.reset(new Uint8[NewCapacity]);
+        m_Capacity = NewCapacity;
+
+        m_OverflowBlocks.clear();
+        m_OverflowSize = 0;
+    }
+    m_Offset = 0;
+}
+
+} // namespace Diligent
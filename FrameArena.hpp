@@ -0,0 +1,88 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "BasicTypes.h"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+/// Linear (bump) allocator for transient per-frame CPU data.
+///
+/// Allocations are valid until the next Reset(). If a frame needs more memory than the
+/// arena holds, the excess is served from overflow blocks and the arena grows to the
+/// frame's peak usage on the next Reset(), so after the first few frames the steady
+/// state performs no heap allocations.
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t InitialCapacity = 64 << 10);
+
+    // clang-format off
+    FrameArena(const FrameArena&)            = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    // clang-format on
+
+    void* Allocate(size_t Size, size_t Alignment = alignof(std::max_align_t));
+
+    /// Allocates and value-initializes Count objects of type T.
+    template <typename T>
+    T* Allocate(size_t Count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "Objects allocated from the arena are never destroyed");
+        T* pObjects = static_cast<T*>(Allocate(sizeof(T) * Count, alignof(T)));
+        for (size_t i = 0; i < Count; ++i)
+            new (pObjects + i) T{};
+        return pObjects;
+    }
+
+    /// Formats a null-terminated string into the arena.
+    const char* Format(const char* Fmt, ...);
+
+    /// Releases all allocations made since the previous Reset().
+    void Reset();
+
+    size_t GetCapacity() const { return m_Capacity; }
+    size_t GetUsedSize() const { return m_Offset + m_OverflowSize; }
+
+private:
+    std::unique_ptr<Uint8[]>              m_pData;
+    size_t                                m_Capacity     = 0;
+    size_t                                m_Offset       = 0;
+    size_t                                m_OverflowSize = 0;
+    std::vector<std::unique_ptr<Uint8[]>> m_OverflowBlocks;
+};
+
+} // namespace Diligent
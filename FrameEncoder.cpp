@@ -0,0 +1,416 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "FrameEncoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+void WriteU8(std::vector<Uint8>& Out, Uint8 Value)
+{
+    Out.push_back(Value);
+}
+
+void WriteU32BE(std::vector<Uint8>& Out, Uint32 Value)
+{
+    Out.push_back(static_cast<Uint8>(Value >> 24u));
+    Out.push_back(static_cast<Uint8>(Value >> 16u));
+    Out.push_back(static_cast<Uint8>(Value >> 8u));
+    Out.push_back(static_cast<Uint8>(Value));
+}
+
+template <typename T>
+void WriteLE(std::vector<Uint8>& Out, T Value)
+{
+    // All supported platforms are little-endian
+    const Uint8* pBytes = reinterpret_cast<const Uint8*>(&Value);
+    Out.insert(Out.end(), pBytes, pBytes + sizeof(T));
+}
+
+void WriteString(std::vector<Uint8>& Out, const char* Str)
+{
+    Out.insert(Out.end(), Str, Str + std::strlen(Str) + 1);
+}
+
+const std::array<Uint32, 256>& GetCRC32Table()
+{
+    static const std::array<Uint32, 256> Table = []() {
+        std::array<Uint32, 256> T{};
+        for (Uint32 n = 0; n < 256; ++n)
+        {
+            Uint32 c = n;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1u) ? 0xEDB88320u ^ (c >> 1u) : c >> 1u;
+            T[n] = c;
+        }
+        return T;
+    }();
+    return Table;
+}
+
+Uint32 UpdateCRC32(Uint32 CRC, const Uint8* pData, size_t Size)
+{
+    const auto& Table = GetCRC32Table();
+    for (size_t i = 0; i < Size; ++i)
+        CRC = Table[(CRC ^ pData[i]) & 0xFFu] ^ (CRC >> 8u);
+    return CRC;
+}
+
+// Writes a PNG chunk; the CRC covers the chunk type and data.
+void WritePNGChunk(std::vector<Uint8>& Out, const char* Type, const Uint8* pData, size_t Size)
+{
+    WriteU32BE(Out, static_cast<Uint32>(Size));
+    const size_t TypeOffset = Out.size();
+    Out.insert(Out.end(), Type, Type + 4);
+    if (Size > 0)
+        Out.insert(Out.end(), pData, pData + Size);
+    const Uint32 CRC = UpdateCRC32(0xFFFFFFFFu, &Out[TypeOffset], Size + 4) ^ 0xFFFFFFFFu;
+    WriteU32BE(Out, CRC);
+}
+
+void EncodePNG(const Uint8* pRGBA, Uint32 Width, Uint32 Height, std::vector<Uint8>& Out)
+{
+    static constexpr Uint8 Signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    Out.insert(Out.end(), std::begin(Signature), std::end(Signature));
+
+    {
+        std::vector<Uint8> IHDR;
+        WriteU32BE(IHDR, Width);
+        WriteU32BE(IHDR, Height);
+        WriteU8(IHDR, 8); // Bit depth
+        WriteU8(IHDR, 6); // Color type: RGBA
+        WriteU8(IHDR, 0); // Compression
+        WriteU8(IHDR, 0); // Filter
+        WriteU8(IHDR, 0); // Interlace
+        WritePNGChunk(Out, "IHDR", IHDR.data(), IHDR.size());
+    }
+
+    // Filtered image data: each row is prefixed with filter type 0 (none).
+    const size_t RowSize = size_t{Width} * 4;
+
+    thread_local std::vector<Uint8> Filtered;
+    Filtered.resize((RowSize + 1) * Height);
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        Uint8* pDst = &Filtered[y * (RowSize + 1)];
+        pDst[0]     = 0;
+        std::memcpy(pDst + 1, pRGBA + y * RowSize, RowSize);
+    }
+
+    // Zlib stream with stored (uncompressed) deflate blocks.
+    constexpr size_t MaxBlockSize = 65535;
+    const size_t     NumBlocks    = std::max<size_t>((Filtered.size() + MaxBlockSize - 1) / MaxBlockSize, 1);
+
+    std::vector<Uint8> IDAT;
+    IDAT.reserve(2 + Filtered.size() + NumBlocks * 5 + 4);
+    WriteU8(IDAT, 0x78); // CMF: deflate, 32K window
+    WriteU8(IDAT, 0x01); // FLG: no dictionary, fastest compression
+
+    for (size_t Block = 0; Block < NumBlocks; ++Block)
+    {
+        const size_t Offset = Block * MaxBlockSize;
+        const size_t Size   = std::min(Filtered.size() - Offset, MaxBlockSize);
+        WriteU8(IDAT, Block + 1 == NumBlocks ? 1 : 0); // BFINAL, BTYPE=00
+        WriteLE(IDAT, static_cast<Uint16>(Size));
+        WriteLE(IDAT, static_cast<Uint16>(~Size));
+        IDAT.insert(IDAT.end(), Filtered.begin() + Offset, Filtered.begin() + Offset + Size);
+    }
+
+    // Adler-32; 5552 is the largest number of bytes that can be summed before the modulo without overflow.
+    Uint32 Adler1 = 1, Adler2 = 0;
+    for (size_t Offset = 0; Offset < Filtered.size(); Offset += 5552)
+    {
+        const size_t End = std::min(Offset + 5552, Filtered.size());
+        for (size_t i = Offset; i < End; ++i)
+        {
+            Adler1 += Filtered[i];
+            Adler2 += Adler1;
+        }
+        Adler1 %= 65521u;
+        Adler2 %= 65521u;
+    }
+    WriteU32BE(IDAT, (Adler2 << 16u) | Adler1);
+
+    WritePNGChunk(Out, "IDAT", IDAT.data(), IDAT.size());
+    WritePNGChunk(Out, "IEND", nullptr, 0);
+}
+
+void WriteEXRAttribute(std::vector<Uint8>& Out, const char* Name, const char* Type, Uint32 Size)
+{
+    WriteString(Out, Name);
+    WriteString(Out, Type);
+    WriteLE(Out, Size);
+}
+
+void EncodeEXR(const Uint8* pRGBA, Uint32 Width, Uint32 Height, std::vector<Uint8>& Out)
+{
+    WriteLE(Out, Uint32{20000630}); // Magic number
+    WriteLE(Out, Uint32{2});        // Version 2, single-part scanline file
+
+    // Channels must be listed in alphabetical order.
+    static constexpr char   ChannelNames[]   = {'A', 'B', 'G', 'R'};
+    static constexpr Uint32 ChannelOffsets[] = {3, 2, 1, 0};
+    static constexpr Int32  PixelTypeFloat   = 2;
+
+    WriteEXRAttribute(Out, "channels", "chlist", 4 * 18 + 1);
+    for (char Name : ChannelNames)
+    {
+        const char NameStr[] = {Name, '\0'};
+        WriteString(Out, NameStr);
+        WriteLE(Out, PixelTypeFloat);
+        WriteLE(Out, Uint32{0}); // pLinear + reserved
+        WriteLE(Out, Int32{1});  // xSampling
+        WriteLE(Out, Int32{1});  // ySampling
+    }
+    WriteU8(Out, 0);
+
+    WriteEXRAttribute(Out, "compression", "compression", 1);
+    WriteU8(Out, 0); // NO_COMPRESSION
+
+    for (const char* WindowName : {"dataWindow", "displayWindow"})
+    {
+        WriteEXRAttribute(Out, WindowName, "box2i", 16);
+        WriteLE(Out, Int32{0});
+        WriteLE(Out, Int32{0});
+        WriteLE(Out, static_cast<Int32>(Width) - 1);
+        WriteLE(Out, static_cast<Int32>(Height) - 1);
+    }
+
+    WriteEXRAttribute(Out, "lineOrder", "lineOrder", 1);
+    WriteU8(Out, 0); // INCREASING_Y
+
+    WriteEXRAttribute(Out, "pixelAspectRatio", "float", 4);
+    WriteLE(Out, 1.f);
+
+    WriteEXRAttribute(Out, "screenWindowCenter", "v2f", 8);
+    WriteLE(Out, 0.f);
+    WriteLE(Out, 0.f);
+
+    WriteEXRAttribute(Out, "screenWindowWidth", "float", 4);
+    WriteLE(Out, 1.f);
+
+    WriteU8(Out, 0); // End of header
+
+    const Uint32 LineDataSize = Width * 4 * sizeof(float);
+    const Uint64 LineSize     = 8 + Uint64{LineDataSize};
+
+    // Line offset table
+    const Uint64 FirstLineOffset = Out.size() + Uint64{Height} * sizeof(Uint64);
+    for (Uint32 y = 0; y < Height; ++y)
+        WriteLE(Out, FirstLineOffset + y * LineSize);
+
+    Out.reserve(Out.size() + Height * LineSize);
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        WriteLE(Out, static_cast<Int32>(y));
+        WriteLE(Out, LineDataSize);
+        const Uint8* pRow = pRGBA + size_t{y} * Width * 4;
+        for (Uint32 Offset : ChannelOffsets)
+        {
+            for (Uint32 x = 0; x < Width; ++x)
+                WriteLE(Out, static_cast<float>(pRow[x * 4 + Offset]) / 255.f);
+        }
+    }
+}
+
+} // namespace
+
+const char* GetFrameEncodeFormatExtension(FRAME_ENCODE_FORMAT Format)
+{
+    switch (Format)
+    {
+        case FRAME_ENCODE_FORMAT_PNG: return "png";
+        case FRAME_ENCODE_FORMAT_EXR: return "exr";
+        case FRAME_ENCODE_FORMAT_RAW: return "rgba";
+        default:
+            UNEXPECTED("Unexpected frame encode format");
+            return "bin";
+    }
+}
+
+void EncodeFrame(FRAME_ENCODE_FORMAT Format, const Uint8* pRGBA, Uint32 Width, Uint32 Height, std::vector<Uint8>& Encoded)
+{
+    Encoded.clear();
+    switch (Format)
+    {
+        case FRAME_ENCODE_FORMAT_PNG:
+            EncodePNG(pRGBA, Width, Height, Encoded);
+            break;
+
+        case FRAME_ENCODE_FORMAT_EXR:
+            EncodeEXR(pRGBA, Width, Height, Encoded);
+            break;
+
+        case FRAME_ENCODE_FORMAT_RAW:
+            Encoded.assign(pRGBA, pRGBA + size_t{Width} * Height * 4);
+            break;
+
+        default:
+            UNEXPECTED("Unexpected frame encode format");
+    }
+}
+
+
+FrameEncodeQueue::FrameEncodeQueue(const CreateInfo& CI) :
+    m_CI{CI}
+{
+    VERIFY_EXPR(m_CI.NumWorkers > 0 && m_CI.Capacity > 0);
+
+    // The job ring and the buffer pool never grow, so pushing a frame does not allocate.
+    m_Jobs.resize(m_CI.Capacity);
+    m_FreeBuffers.reserve(m_CI.Capacity);
+
+    m_Workers.reserve(m_CI.NumWorkers);
+    for (Uint32 i = 0; i < m_CI.NumWorkers; ++i)
+        m_Workers.emplace_back(&FrameEncodeQueue::WorkerThread, this);
+}
+
+FrameEncodeQueue::~FrameEncodeQueue()
+{
+    // Finish all pending frames before shutting down.
+    WaitIdle();
+
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_Stop = true;
+    }
+    m_JobAvailableCV.notify_all();
+
+    for (std::thread& Worker : m_Workers)
+        Worker.join();
+}
+
+std::vector<Uint8> FrameEncodeQueue::AcquireBuffer(size_t Size)
+{
+    std::vector<Uint8> Buffer;
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        if (!m_FreeBuffers.empty())
+        {
+            Buffer = std::move(m_FreeBuffers.back());
+            m_FreeBuffers.pop_back();
+        }
+    }
+    Buffer.resize(Size);
+    return Buffer;
+}
+
+bool FrameEncodeQueue::TryPush(FrameEncodeJob& Job)
+{
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        if (m_NumJobs >= m_CI.Capacity)
+            return false;
+        m_Jobs[(m_FirstJob + m_NumJobs) % m_CI.Capacity] = std::move(Job);
+        ++m_NumJobs;
+    }
+    m_JobAvailableCV.notify_one();
+    return true;
+}
+
+bool FrameEncodeQueue::IsFull()
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    return m_NumJobs >= m_CI.Capacity;
+}
+
+void FrameEncodeQueue::WaitIdle()
+{
+    std::unique_lock<std::mutex> Lock{m_Mtx};
+    m_IdleCV.wait(Lock, [this]() { return m_NumJobs == 0 && m_NumBusyWorkers == 0; });
+}
+
+void FrameEncodeQueue::WorkerThread()
+{
+    if (m_CI.OnWorkerStarted)
+        m_CI.OnWorkerStarted();
+
+    std::vector<Uint8> Encoded;
+    while (true)
+    {
+        FrameEncodeJob Job;
+        {
+            std::unique_lock<std::mutex> Lock{m_Mtx};
+            m_JobAvailableCV.wait(Lock, [this]() { return m_Stop || m_NumJobs > 0; });
+            if (m_NumJobs == 0)
+                return; // m_Stop is set and there is no more work
+
+            Job        = std::move(m_Jobs[m_FirstJob]);
+            m_FirstJob = (m_FirstJob + 1) % m_CI.Capacity;
+            --m_NumJobs;
+            ++m_NumBusyWorkers;
+        }
+
+        ProcessJob(Job, Encoded);
+
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+            // Keep at most one spare buffer per queue slot.
+            if (m_FreeBuffers.size() < m_CI.Capacity)
+                m_FreeBuffers.emplace_back(std::move(Job.Pixels));
+            --m_NumBusyWorkers;
+        }
+        m_IdleCV.notify_all();
+    }
+}
+
+void FrameEncodeQueue::ProcessJob(FrameEncodeJob& Job, std::vector<Uint8>& Encoded)
+{
+    VERIFY_EXPR(Job.Pixels.size() == size_t{Job.Width} * Job.Height * 4);
+    EncodeFrame(m_CI.Format, Job.Pixels.data(), Job.Width, Job.Height, Encoded);
+
+    if (m_CI.OnEncoded)
+    {
+        m_CI.OnEncoded(Job, Encoded);
+        m_NumEncoded.fetch_add(1);
+        return;
+    }
+
+    std::string FilePath = m_CI.OutputPrefix;
+    FilePath += std::to_string(Job.FrameIndex);
+    if (m_CI.Format == FRAME_ENCODE_FORMAT_RAW)
+    {
+        FilePath += '_';
+        FilePath += std::to_string(Job.Width);
+        FilePath += 'x';
+        FilePath += std::to_string(Job.Height);
+    }
+    FilePath += '.';
+    FilePath += GetFrameEncodeFormatExtension(m_CI.Format);
+
+    std::ofstream File{FilePath, std::ios::out | std::ios::binary | std::ios::trunc};
+    File.write(reinterpret_cast<const char*>(Encoded.data()), static_cast<std::streamsize>(Encoded.size()));
+    if (!File)
+    {
+        LOG_ERROR_MESSAGE("Failed to write frame to '", FilePath, "'");
+        m_NumFailed.fetch_add(1);
+        return;
+    }
+    m_NumEncoded.fetch_add(1);
+}
+
+} // namespace Diligent
@@ -0,0 +1,139 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+enum FRAME_ENCODE_FORMAT : Uint8
+{
+    FRAME_ENCODE_FORMAT_PNG = 0,
+    FRAME_ENCODE_FORMAT_EXR,
+    FRAME_ENCODE_FORMAT_RAW
+};
+
+/// Returns the file extension (without the dot) for the format.
+const char* GetFrameEncodeFormatExtension(FRAME_ENCODE_FORMAT Format);
+
+/// Encodes a tightly packed RGBA8 image into the requested format.
+///
+/// PNG images are written with uncompressed deflate blocks: the encoder is meant to keep up
+/// with the frame rate rather than to produce small files.
+/// EXR images are uncompressed scanline files with 32-bit float channels holding the normalized
+/// 8-bit values. RAW images are the pixel data as is.
+void EncodeFrame(FRAME_ENCODE_FORMAT Format, const Uint8* pRGBA, Uint32 Width, Uint32 Height, std::vector<Uint8>& Encoded);
+
+
+struct FrameEncodeJob
+{
+    Uint64             FrameIndex = 0;
+    Uint32             Width      = 0;
+    Uint32             Height     = 0;
+    std::vector<Uint8> Pixels; // Tightly packed RGBA8
+};
+
+/// Bounded queue that encodes frames on worker threads.
+///
+/// Producers never block: TryPush() fails when the queue is full, and it is up to
+/// the producer to retry later or drop the frame. Pixel buffers are recycled through
+/// AcquireBuffer(), so the steady state does not allocate.
+class FrameEncodeQueue
+{
+public:
+    /// Called on a worker thread for every encoded frame. If not set, frames are
+    /// written to "<OutputPrefix><FrameIndex>.<ext>".
+    using EncodedCallbackType = std::function<void(const FrameEncodeJob& Job, const std::vector<Uint8>& Encoded)>;
+
+    /// Called at the start of every worker thread.
+    using WorkerStartedCallbackType = std::function<void()>;
+
+    struct CreateInfo
+    {
+        FRAME_ENCODE_FORMAT       Format       = FRAME_ENCODE_FORMAT_PNG;
+        std::string               OutputPrefix = "frame_";
+        Uint32                    NumWorkers   = 2;
+        Uint32                    Capacity     = 8;
+        EncodedCallbackType       OnEncoded;
+        WorkerStartedCallbackType OnWorkerStarted;
+    };
+
+    explicit FrameEncodeQueue(const CreateInfo& CI);
+    ~FrameEncodeQueue();
+
+    // clang-format off
+    FrameEncodeQueue(const FrameEncodeQueue&)            = delete;
+    FrameEncodeQueue& operator=(const FrameEncodeQueue&) = delete;
+    // clang-format on
+
+    /// Returns a buffer of the given size, reusing a previously released one if possible.
+    std::vector<Uint8> AcquireBuffer(size_t Size);
+
+    /// Enqueues the job. Returns false if the queue is full, in which case Job is left unchanged.
+    bool TryPush(FrameEncodeJob& Job);
+
+    bool IsFull();
+
+    /// Blocks until all queued frames have been encoded.
+    void WaitIdle();
+
+    Uint64 GetNumEncoded() const { return m_NumEncoded.load(); }
+    Uint64 GetNumFailed() const { return m_NumFailed.load(); }
+
+private:
+    void WorkerThread();
+    void ProcessJob(FrameEncodeJob& Job, std::vector<Uint8>& Encoded);
+
+    const CreateInfo m_CI;
+
+    std::mutex                      m_Mtx;
+    std::condition_variable         m_JobAvailableCV;
+    std::condition_variable         m_IdleCV;
+    std::vector<FrameEncodeJob>     m_Jobs; // Ring buffer of Capacity slots
+    Uint32                          m_FirstJob       = 0;
+    Uint32                          m_NumJobs        = 0;
+    std::vector<std::vector<Uint8>> m_FreeBuffers;
+    Uint32                          m_NumBusyWorkers = 0;
+    bool                            m_Stop           = false;
+
+    std::vector<std::thread> m_Workers;
+
+    std::atomic<Uint64> m_NumEncoded{0};
+    std::atomic<Uint64> m_NumFailed{0};
+};
+
+} // namespace Diligent
@@ -0,0 +1,174 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "FrameReadback.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+FrameReadback::FrameReadback(IRenderDevice* pDevice, IDeviceContext* pContext, const CreateInfo& CI) :
+    m_pDevice{pDevice},
+    m_pContext{pContext},
+    m_Slots(std::max(CI.RingSize, 1u)),
+    m_pEncodeQueue{std::make_unique<FrameEncodeQueue>(CI.Encoder)}
+{
+    FenceDesc Desc;
+    Desc.Name = "Frame readback fence";
+    Desc.Type = FENCE_TYPE_CPU_WAIT_ONLY;
+    m_pDevice->CreateFence(Desc, &m_pFence);
+    VERIFY_EXPR(m_pFence != nullptr);
+}
+
+FrameReadback::~FrameReadback()
+{
+    Flush();
+    LOG_INFO_MESSAGE("Frame readback finished: ", GetNumEncoded(), " frame(s) encoded, ",
+                     GetNumSkipped(), " skipped, ", GetNumFailed(), " failed");
+    m_pEncodeQueue.reset();
+}
+
+bool FrameReadback::Capture(ITexture* pSrcTexture, Uint64 FrameIndex)
+{
+    const TextureDesc& SrcDesc = pSrcTexture->GetDesc();
+    VERIFY(SrcDesc.Format == TEX_FORMAT_RGBA8_UNORM || SrcDesc.Format == TEX_FORMAT_RGBA8_UNORM_SRGB,
+           "Only RGBA8 textures can be captured");
+
+    Slot& S = m_Slots[m_NextSlot];
+    if (S.InFlight)
+    {
+        // The oldest frame is still in flight or waiting for the encoder: skip this frame.
+        ++m_NumSkipped;
+        return false;
+    }
+
+    if (!S.pStagingTex ||
+        S.pStagingTex->GetDesc().Width != SrcDesc.Width ||
+        S.pStagingTex->GetDesc().Height != SrcDesc.Height ||
+        S.pStagingTex->GetDesc().Format != SrcDesc.Format)
+    {
+        TextureDesc StagingDesc;
+        StagingDesc.Name           = "Frame readback staging texture";
+        StagingDesc.Type           = RESOURCE_DIM_TEX_2D;
+        StagingDesc.Width          = SrcDesc.Width;
+        StagingDesc.Height         = SrcDesc.Height;
+        StagingDesc.Format         = SrcDesc.Format;
+        StagingDesc.Usage          = USAGE_STAGING;
+        StagingDesc.CPUAccessFlags = CPU_ACCESS_READ;
+
+        S.pStagingTex.Release();
+        m_pDevice->CreateTexture(StagingDesc, nullptr, &S.pStagingTex);
+        VERIFY_EXPR(S.pStagingTex != nullptr);
+    }
+
+    CopyTextureAttribs CopyAttribs{pSrcTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                                   S.pStagingTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+    m_pContext->CopyTexture(CopyAttribs);
+
+    S.FenceValue = m_NextFenceValue++;
+    S.FrameIndex = FrameIndex;
+    S.InFlight   = true;
+    m_pContext->EnqueueSignal(m_pFence, S.FenceValue);
+
+    m_NextSlot = (m_NextSlot + 1) % static_cast<Uint32>(m_Slots.size());
+    return true;
+}
+
+void FrameReadback::Poll()
+{
+    const Uint64 CompletedValue = m_pFence->GetCompletedValue();
+
+    // Process slots in submission order so that frames reach the encoder in order.
+    for (size_t i = 0; i < m_Slots.size(); ++i)
+    {
+        Slot& S = m_Slots[(m_NextSlot + i) % m_Slots.size()];
+        if (!S.InFlight)
+            continue;
+        if (S.FenceValue > CompletedValue || !TryEncodeSlot(S, false))
+            break;
+    }
+}
+
+void FrameReadback::Flush()
+{
+    // Submit the pending copies so that the fence can be signaled.
+    m_pContext->Flush();
+
+    for (size_t i = 0; i < m_Slots.size(); ++i)
+    {
+        Slot& S = m_Slots[(m_NextSlot + i) % m_Slots.size()];
+        if (!S.InFlight)
+            continue;
+        m_pFence->Wait(S.FenceValue);
+        TryEncodeSlot(S, true);
+    }
+
+    m_pEncodeQueue->WaitIdle();
+}
+
+bool FrameReadback::TryEncodeSlot(Slot& S, bool Wait)
+{
+    // Keep the frame in the staging texture until the encoder catches up.
+    // This is the only producer, so the queue can't fill up before TryPush() below.
+    if (m_pEncodeQueue->IsFull())
+    {
+        if (!Wait)
+            return false;
+        m_pEncodeQueue->WaitIdle();
+    }
+
+    MappedTextureSubresource MappedData;
+    m_pContext->MapTextureSubresource(S.pStagingTex, 0, 0, MAP_READ, Wait ? MAP_FLAG_NONE : MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+    if (MappedData.pData == nullptr)
+    {
+        if (Wait)
+        {
+            LOG_ERROR_MESSAGE("Failed to map the staging texture of frame ", S.FrameIndex);
+            S.InFlight = false;
+            ++m_NumMapFailures;
+        }
+        return false;
+    }
+
+    const TextureDesc& Desc    = S.pStagingTex->GetDesc();
+    const size_t       RowSize = size_t{Desc.Width} * 4;
+
+    FrameEncodeJob Job;
+    Job.FrameIndex = S.FrameIndex;
+    Job.Width      = Desc.Width;
+    Job.Height     = Desc.Height;
+    Job.Pixels     = m_pEncodeQueue->AcquireBuffer(RowSize * Desc.Height);
+
+    const Uint8* pSrc = static_cast<const Uint8*>(MappedData.pData);
+    for (Uint32 y = 0; y < Desc.Height; ++y)
+        std::memcpy(&Job.Pixels[y * RowSize], pSrc + y * MappedData.Stride, RowSize);
+    m_pContext->UnmapTextureSubresource(S.pStagingTex, 0, 0);
+
+    S.InFlight = false;
+
+    const bool Pushed = m_pEncodeQueue->TryPush(Job);
+    VERIFY_EXPR(Pushed);
+    (void)Pushed;
+
+    return true;
+}
+
+} // namespace Diligent
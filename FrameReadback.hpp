@@ -0,0 +1,98 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "RenderDevice.h"
+#include "DeviceContext.h"
+#include "RefCntAutoPtr.hpp"
+#include "FrameEncoder.hpp"
+
+namespace Diligent
+{
+
+/// Copies frames to a ring of staging textures and hands them over to a FrameEncodeQueue
+/// once the GPU has finished the copy. Neither Capture() nor Poll() ever wait for the GPU
+/// or the encoder: when all staging textures are in flight, new frames are skipped, and when
+/// the encode queue is full, completed frames stay in their staging textures until the next Poll().
+/// Flush() is the only blocking call; the destructor calls it so that no captured frame is lost.
+class FrameReadback
+{
+public:
+    struct CreateInfo
+    {
+        Uint32                       RingSize = 3;
+        FrameEncodeQueue::CreateInfo Encoder;
+    };
+
+    FrameReadback(IRenderDevice* pDevice, IDeviceContext* pContext, const CreateInfo& CI);
+    ~FrameReadback();
+
+    /// Schedules a copy of mip 0 of pSrcTexture (must be RGBA8) into a free staging texture.
+    /// Returns false if all staging textures are busy and the frame was skipped.
+    bool Capture(ITexture* pSrcTexture, Uint64 FrameIndex);
+
+    /// Moves frames whose copies have completed to the encode queue.
+    void Poll();
+
+    /// Waits for all pending copies, pushes them to the encode queue and waits
+    /// until every frame has been written.
+    void Flush();
+
+    Uint64 GetNumSkipped() const { return m_NumSkipped; }
+    Uint64 GetNumEncoded() const { return m_pEncodeQueue->GetNumEncoded(); }
+    Uint64 GetNumFailed() const { return m_pEncodeQueue->GetNumFailed() + m_NumMapFailures; }
+
+private:
+    struct Slot
+    {
+        RefCntAutoPtr<ITexture> pStagingTex;
+        Uint64                  FenceValue = 0;
+        Uint64                  FrameIndex = 0;
+        bool                    InFlight   = false;
+    };
+
+    // When Wait is true, waits for the encode queue and for the map instead of giving up.
+    bool TryEncodeSlot(Slot& S, bool Wait);
+
+    RefCntAutoPtr<IRenderDevice>  m_pDevice;
+    RefCntAutoPtr<IDeviceContext> m_pContext;
+    RefCntAutoPtr<IFence>         m_pFence;
+    Uint64                        m_NextFenceValue = 1;
+
+    std::vector<Slot> m_Slots;
+    Uint32            m_NextSlot       = 0;
+    Uint64            m_NumSkipped     = 0;
+    Uint64            m_NumMapFailures = 0;
+
+    std::unique_ptr<FrameEncodeQueue> m_pEncodeQueue;
+};
+
+} // namespace Diligent
@@ -0,0 +1,217 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "LightBVH.hpp"
+
+#include <algorithm>
+
+#include "DebugUtilities.hpp"
+#include "WorkerPool.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Subtrees with fewer lights are built on the current thread.
+constexpr Uint32 MinParallelBuildLights = 2048;
+
+float GetLightPower(const LightAttribs& Light)
+{
+    const float Luminance = 0.2126f * Light.Color.x + 0.7152f * Light.Color.y + 0.0722f * Light.Color.z;
+    return Luminance * Light.Intensity;
+}
+
+} // namespace
+
+void LightBVH::Build(const LightAttribs* pLights, Uint32 NumLights, Uint32 NumThreads)
+{
+    m_pLights = pLights;
+    m_Nodes.resize(NumLights > 0 ? NumLights * 2 - 1 : 0);
+    m_Indices.resize(NumLights);
+    m_Centroids.resize(NumLights);
+    if (NumLights == 0)
+        return;
+
+    for (Uint32 i = 0; i < NumLights; ++i)
+    {
+        m_Indices[i]   = i;
+        m_Centroids[i] = pLights[i].Position;
+    }
+
+    WorkerPool& Pool = WorkerPool::GetDefault();
+
+    // The split only depends on the requested thread count, not on the size of the pool,
+    // so the resulting tree is the same on any machine.
+    const Uint32 MaxThreads = NumThreads != 0 ? NumThreads : Pool.GetNumThreads();
+
+    // Split until there are about four subtrees per thread so that uneven subtrees balance out.
+    Uint32 ParallelDepth = 0;
+    while (MaxThreads > 1 && (1u << ParallelDepth) < MaxThreads * 4)
+        ++ParallelDepth;
+
+    m_Subtrees.clear();
+    SplitTopLevels(0, 0, NumLights, ParallelDepth);
+
+    Pool.ParallelFor(
+        static_cast<Uint32>(m_Subtrees.size()), [this](Uint32 FirstSubtree, Uint32 EndSubtree) {
+            for (Uint32 i = FirstSubtree; i < EndSubtree; ++i)
+                BuildNode(m_Subtrees[i].NodeIdx, m_Subtrees[i].First, m_Subtrees[i].Count);
+        },
+        MaxThreads);
+
+    UpdateTopLevels(0, NumLights, ParallelDepth);
+}
+
+Uint32 LightBVH::SplitNode(Uint32 First, Uint32 Count)
+{
+    // Split at the median of the longest axis of the centroid bounds. This keeps the
+    // tree balanced, so the node layout is known in advance and subtrees can be built
+    // independently.
+    float3 CentroidMin = m_Centroids[m_Indices[First]];
+    float3 CentroidMax = CentroidMin;
+    for (Uint32 i = First + 1; i < First + Count; ++i)
+    {
+        CentroidMin = std::min(CentroidMin, m_Centroids[m_Indices[i]]);
+        CentroidMax = std::max(CentroidMax, m_Centroids[m_Indices[i]]);
+    }
+    const float3 Extent = CentroidMax - CentroidMin;
+    const int    Axis   = (Extent.x >= Extent.y && Extent.x >= Extent.z) ? 0 : (Extent.y >= Extent.z ? 1 : 2);
+
+    const Uint32 LeftCount = Count / 2;
+    auto*        pBegin    = m_Indices.data() + First;
+    std::nth_element(pBegin, pBegin + LeftCount, pBegin + Count,
+                     [this, Axis](Uint32 a, Uint32 b) { return m_Centroids[a][Axis] < m_Centroids[b][Axis]; });
+    return LeftCount;
+}
+
+void LightBVH::BuildNode(Uint32 NodeIdx, Uint32 First, Uint32 Count)
+{
+    if (Count == 1)
+    {
+        const Uint32        LightIdx = m_Indices[First];
+        const LightAttribs& Light    = m_pLights[LightIdx];
+
+        LightBVHNode& Node = m_Nodes[NodeIdx];
+        Node.BoundsMin     = Light.Position - float3{Light.Radius, Light.Radius, Light.Radius};
+        Node.BoundsMax     = Light.Position + float3{Light.Radius, Light.Radius, Light.Radius};
+        Node.Power         = GetLightPower(Light);
+        Node.ChildOrLight  = LightIdx | LIGHT_BVH_LEAF_FLAG;
+        return;
+    }
+
+    const Uint32 LeftCount = SplitNode(First, Count);
+
+    // A subtree with N leaves occupies 2N-1 nodes.
+    const Uint32 LeftIdx  = NodeIdx + 1;
+    const Uint32 RightIdx = NodeIdx + 2 * LeftCount;
+
+    BuildNode(LeftIdx, First, LeftCount);
+    BuildNode(RightIdx, First + LeftCount, Count - LeftCount);
+    UpdateInnerNode(NodeIdx, LeftIdx, RightIdx);
+}
+
+void LightBVH::UpdateInnerNode(Uint32 NodeIdx, Uint32 LeftIdx, Uint32 RightIdx)
+{
+    const LightBVHNode& Left  = m_Nodes[LeftIdx];
+    const LightBVHNode& Right = m_Nodes[RightIdx];
+
+    LightBVHNode& Node = m_Nodes[NodeIdx];
+    Node.BoundsMin     = std::min(Left.BoundsMin, Right.BoundsMin);
+    Node.BoundsMax     = std::max(Left.BoundsMax, Right.BoundsMax);
+    Node.Power         = Left.Power + Right.Power;
+    Node.ChildOrLight  = RightIdx;
+}
+
+void LightBVH::SplitTopLevels(Uint32 NodeIdx, Uint32 First, Uint32 Count, Uint32 Depth)
+{
+    if (Depth == 0 || Count < MinParallelBuildLights)
+    {
+        m_Subtrees.push_back({NodeIdx, First, Count});
+        return;
+    }
+
+    const Uint32 LeftCount = SplitNode(First, Count);
+    SplitTopLevels(NodeIdx + 1, First, LeftCount, Depth - 1);
+    SplitTopLevels(NodeIdx + 2 * LeftCount, First + LeftCount, Count - LeftCount, Depth - 1);
+}
+
+void LightBVH::UpdateTopLevels(Uint32 NodeIdx, Uint32 Count, Uint32 Depth)
+{
+    // Mirrors the recursion of SplitTopLevels(): the left child has Count / 2 lights.
+    if (Depth == 0 || Count < MinParallelBuildLights)
+        return;
+
+    const Uint32 LeftCount = Count / 2;
+    const Uint32 LeftIdx   = NodeIdx + 1;
+    const Uint32 RightIdx  = NodeIdx + 2 * LeftCount;
+    UpdateTopLevels(LeftIdx, LeftCount, Depth - 1);
+    UpdateTopLevels(RightIdx, Count - LeftCount, Depth - 1);
+    UpdateInnerNode(NodeIdx, LeftIdx, RightIdx);
+}
+
+float LightBVH::GetNodeImportance(const LightBVHNode& Node, const float3& Position)
+{
+    // Power falls off with the squared distance to the node center, but the distance is
+    // clamped to the node size so that points inside large nodes don't get infinite importance.
+    const float3 Center = (Node.BoundsMin + Node.BoundsMax) * 0.5f;
+    const float3 Diag   = Node.BoundsMax - Node.BoundsMin;
+    const float3 ToNode = Center - Position;
+    const float  DistSq = dot(ToNode, ToNode);
+    const float  ExtSq  = dot(Diag, Diag) * 0.25f;
+    return Node.Power / std::max(std::max(DistSq, ExtSq), 1e-4f);
+}
+
+Uint32 LightBVH::SampleLight(const float3& Position, float u, float& Pdf) const
+{
+    Pdf = 0;
+    if (m_Nodes.empty() || m_Nodes[0].Power <= 0)
+        return ~0u;
+
+    Pdf = 1;
+
+    Uint32 NodeIdx = 0;
+    while ((m_Nodes[NodeIdx].ChildOrLight & LIGHT_BVH_LEAF_FLAG) == 0)
+    {
+        const Uint32 LeftIdx  = NodeIdx + 1;
+        const Uint32 RightIdx = m_Nodes[NodeIdx].ChildOrLight;
+
+        const float ImportanceL = GetNodeImportance(m_Nodes[LeftIdx], Position);
+        const float ImportanceR = GetNodeImportance(m_Nodes[RightIdx], Position);
+        const float Total       = ImportanceL + ImportanceR;
+        const float ProbL       = Total > 0 ? ImportanceL / Total : 0.5f;
+
+        // Reuse the random number by rescaling it to [0, 1) within the selected interval.
+        if (u < ProbL)
+        {
+            u = std::min(u / ProbL, 0.99999994f);
+            Pdf *= ProbL;
+            NodeIdx = LeftIdx;
+        }
+        else
+        {
+            u = std::min((u - ProbL) / (1.f - ProbL), 0.99999994f);
+            Pdf *= 1.f - ProbL;
+            NodeIdx = RightIdx;
+        }
+    }
+
+    return m_Nodes[NodeIdx].ChildOrLight & ~LIGHT_BVH_LEAF_FLAG;
+}
+
+} // namespace Diligent
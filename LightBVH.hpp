@@ -0,0 +1,114 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "BasicMath.hpp"
+
+namespace Diligent
+{
+
+/// Point or spherical area light as stored in the light structured buffer.
+struct LightAttribs
+{
+    float3 Position;
+    float  Radius = 0; // 0 for point lights
+
+    float3 Color;
+    float  Intensity = 1;
+};
+static_assert(sizeof(LightAttribs) == 32, "LightAttribs layout must match the shader structure");
+
+/// Light BVH node as stored in the node structured buffer.
+///
+/// Nodes are stored in depth-first order: the left child of an inner node immediately
+/// follows its parent, ChildOrLight is the index of the right child. For leaves,
+/// ChildOrLight is the light index combined with LIGHT_BVH_LEAF_FLAG.
+struct LightBVHNode
+{
+    float3 BoundsMin;
+    float  Power = 0; // Total emitted power of the subtree
+
+    float3 BoundsMax;
+    Uint32 ChildOrLight = 0;
+};
+static_assert(sizeof(LightBVHNode) == 32, "LightBVHNode layout must match the shader structure");
+
+static constexpr Uint32 LIGHT_BVH_LEAF_FLAG = 0x80000000u;
+
+/// Binary light hierarchy for importance-based light selection (similar to lightcuts and
+/// the PBRT-v4 light BVH). Each leaf holds one light, so a tree of N lights has 2N-1 nodes
+/// and selecting a light takes O(log N) steps regardless of the light count.
+class LightBVH
+{
+public:
+    /// Rebuilds the tree. The top levels are split on the calling thread into about four subtrees
+    /// per thread for NumThreads threads (0 means the size of the default WorkerPool), then subtrees
+    /// with many lights are built in parallel on the default WorkerPool. The nodes are identical
+    /// for any NumThreads. Internal storage is reused, so rebuilding with the same light count
+    /// doesn't allocate.
+    void Build(const LightAttribs* pLights, Uint32 NumLights, Uint32 NumThreads = 0);
+
+    const std::vector<LightBVHNode>& GetNodes() const { return m_Nodes; }
+
+    /// CPU reference of the shader-side traversal: stochastically selects a light
+    /// proportionally to its estimated contribution at Position using the random number u in [0, 1).
+    /// Returns the light index and its selection probability in Pdf.
+    Uint32 SampleLight(const float3& Position, float u, float& Pdf) const;
+
+    /// Returns the estimated contribution of the node's lights to a point at Position.
+    static float GetNodeImportance(const LightBVHNode& Node, const float3& Position);
+
+private:
+    struct Subtree
+    {
+        Uint32 NodeIdx;
+        Uint32 First;
+        Uint32 Count;
+    };
+
+    // Partitions lights [First, First + Count) of an inner node and returns the number of lights in the left child.
+    Uint32 SplitNode(Uint32 First, Uint32 Count);
+    void   BuildNode(Uint32 NodeIdx, Uint32 First, Uint32 Count);
+    void   UpdateInnerNode(Uint32 NodeIdx, Uint32 LeftIdx, Uint32 RightIdx);
+
+    // Splits the top Depth levels and adds the subtrees below them to m_Subtrees.
+    void SplitTopLevels(Uint32 NodeIdx, Uint32 First, Uint32 Count, Uint32 Depth);
+    // Computes the nodes above the subtrees once they have been built.
+    void UpdateTopLevels(Uint32 NodeIdx, Uint32 Count, Uint32 Depth);
+
+    const LightAttribs* m_pLights = nullptr;
+
+    std::vector<LightBVHNode> m_Nodes;
+    std::vector<Uint32>       m_Indices;
+    std::vector<float3>       m_Centroids;
+    std::vector<Subtree>      m_Subtrees;
+};
+
+} // namespace Diligent
@@ -0,0 +1,137 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "MultiView.hpp"
+
+#include <cmath>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+struct CubemapFaceBasis
+{
+    float3 Forward;
+    float3 Up;
+};
+
+// Up vectors follow the D3D cubemap convention, so that the right axis cross(Up, Forward)
+// matches the direction of increasing U of the face.
+const CubemapFaceBasis CubemapFaceBases[CUBEMAP_FACE_COUNT] = {
+    {float3{+1, 0, 0}, float3{0, 1, 0}},
+    {float3{-1, 0, 0}, float3{0, 1, 0}},
+    {float3{0, +1, 0}, float3{0, 0, -1}},
+    {float3{0, -1, 0}, float3{0, 0, 1}},
+    {float3{0, 0, +1}, float3{0, 1, 0}},
+    {float3{0, 0, -1}, float3{0, 1, 0}},
+};
+
+} // namespace
+
+float4x4 GetCubemapFaceViewMatrix(CUBEMAP_FACE Face, const float3& Position)
+{
+    VERIFY_EXPR(Face < CUBEMAP_FACE_COUNT);
+
+    const CubemapFaceBasis& Basis = CubemapFaceBases[Face];
+    const float3            Right = cross(Basis.Up, Basis.Forward);
+    return float4x4::Translation(-Position) * float4x4::ViewFromBasis(Right, Basis.Up, Basis.Forward);
+}
+
+float4x4 GetCubemapFaceProjMatrix(float NearZ, float FarZ, bool IsGL)
+{
+    return float4x4::Projection(PI_F / 2.f, 1.f, NearZ, FarZ, IsGL);
+}
+
+void GetCubemapViews(const float3& Position, float NearZ, float FarZ, bool IsGL, MultiViewCamera* pViews)
+{
+    const float4x4 Proj = GetCubemapFaceProjMatrix(NearZ, FarZ, IsGL);
+    for (Uint32 Face = 0; Face < CUBEMAP_FACE_COUNT; ++Face)
+    {
+        MultiViewCamera& View = pViews[Face];
+        View.Position         = Position;
+        View.View             = GetCubemapFaceViewMatrix(static_cast<CUBEMAP_FACE>(Face), Position);
+        View.Proj             = Proj;
+    }
+}
+
+void GetStereoViews(const float4x4& View, const float4x4& Proj, float EyeSeparation, MultiViewCamera* pViews)
+{
+    const float4x4 CameraWorld = View.Inverse();
+    const float3   Right       = normalize(float3{CameraWorld.m[0][0], CameraWorld.m[0][1], CameraWorld.m[0][2]});
+    const float3   Center      = float3{CameraWorld.m[3][0], CameraWorld.m[3][1], CameraWorld.m[3][2]};
+
+    for (Uint32 Eye = 0; Eye < 2; ++Eye)
+    {
+        // Moving the eye by Offset in world space moves the world by -Offset in view space.
+        const float3 Offset = Right * (Eye == 0 ? -0.5f : 0.5f) * EyeSeparation;
+
+        MultiViewCamera& EyeView = pViews[Eye];
+        EyeView.Position         = Center + Offset;
+        EyeView.View             = float4x4::Translation(-Offset) * View;
+        EyeView.Proj             = Proj;
+    }
+}
+
+CUBEMAP_FACE GetCubemapFace(const float3& Direction, float2& UV)
+{
+    const float AbsX = std::abs(Direction.x);
+    const float AbsY = std::abs(Direction.y);
+    const float AbsZ = std::abs(Direction.z);
+
+    CUBEMAP_FACE Face;
+    float        MajorAxis, S, T;
+    if (AbsX >= AbsY && AbsX >= AbsZ)
+    {
+        Face      = Direction.x >= 0 ? CUBEMAP_FACE_POS_X : CUBEMAP_FACE_NEG_X;
+        MajorAxis = AbsX;
+        S         = Direction.x >= 0 ? -Direction.z : Direction.z;
+        T         = -Direction.y;
+    }
+    else if (AbsY >= AbsZ)
+    {
+        Face      = Direction.y >= 0 ? CUBEMAP_FACE_POS_Y : CUBEMAP_FACE_NEG_Y;
+        MajorAxis = AbsY;
+        S         = Direction.x;
+        T         = Direction.y >= 0 ? Direction.z : -Direction.z;
+    }
+    else
+    {
+        Face      = Direction.z >= 0 ? CUBEMAP_FACE_POS_Z : CUBEMAP_FACE_NEG_Z;
+        MajorAxis = AbsZ;
+        S         = Direction.z >= 0 ? Direction.x : -Direction.x;
+        T         = -Direction.y;
+    }
+
+    UV.x = (S / MajorAxis + 1.f) * 0.5f;
+    UV.y = (T / MajorAxis + 1.f) * 0.5f;
+    return Face;
+}
+
+void WriteMultiViewAttribs(const MultiViewCamera* pViews, Uint32 NumViews, MultiViewAttribs* pAttribs)
+{
+    for (Uint32 i = 0; i < NumViews; ++i)
+    {
+        pAttribs[i].InvViewProj = (pViews[i].View * pViews[i].Proj).Inverse();
+        pAttribs[i].CameraPos   = float4{pViews[i].Position, 1};
+    }
+}
+
+} // namespace Diligent
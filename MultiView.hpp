@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include "BasicMath.hpp"
+
+namespace Diligent
+{
+
+/// Camera of a single view in a multi-view batch.
+struct MultiViewCamera
+{
+    float3   Position;
+    float4x4 View;
+    float4x4 Proj;
+};
+
+/// Per-view data as stored in the g_Views structured buffer. Ray generation shaders
+/// compiled with MULTI_VIEW select the view with DispatchRaysIndex().z.
+struct MultiViewAttribs
+{
+    float4x4 InvViewProj;
+    float4   CameraPos;
+};
+static_assert(sizeof(MultiViewAttribs) == 80, "MultiViewAttribs layout must match the shader structure");
+
+/// Cubemap faces in the D3D/Vulkan array slice order.
+enum CUBEMAP_FACE : Uint32
+{
+    CUBEMAP_FACE_POS_X = 0,
+    CUBEMAP_FACE_NEG_X,
+    CUBEMAP_FACE_POS_Y,
+    CUBEMAP_FACE_NEG_Y,
+    CUBEMAP_FACE_POS_Z,
+    CUBEMAP_FACE_NEG_Z,
+    CUBEMAP_FACE_COUNT
+};
+
+/// Returns the view matrix of the face of a cubemap centered at Position. Images traced
+/// with these matrices (UV origin in the top-left corner) can be used as cubemap faces directly.
+float4x4 GetCubemapFaceViewMatrix(CUBEMAP_FACE Face, const float3& Position);
+
+/// Returns the 90-degree square projection shared by all cubemap faces.
+float4x4 GetCubemapFaceProjMatrix(float NearZ, float FarZ, bool IsGL);
+
+/// Writes CUBEMAP_FACE_COUNT views of a cubemap centered at Position to pViews.
+void GetCubemapViews(const float3& Position, float NearZ, float FarZ, bool IsGL, MultiViewCamera* pViews);
+
+/// Writes the left and right eye views for the camera with the given View and Proj matrices.
+/// The eyes are offset by half of EyeSeparation along the camera's right axis and look in
+/// the same direction (parallel stereo).
+void GetStereoViews(const float4x4& View, const float4x4& Proj, float EyeSeparation, MultiViewCamera* pViews);
+
+/// Returns the cubemap face that Direction points to and the texture coordinates
+/// within the face (CPU reference of cubemap sampling).
+CUBEMAP_FACE GetCubemapFace(const float3& Direction, float2& UV);
+
+/// Converts cameras to the layout of the g_Views buffer.
+void WriteMultiViewAttribs(const MultiViewCamera* pViews, Uint32 NumViews, MultiViewAttribs* pAttribs);
+
+} // namespace Diligent
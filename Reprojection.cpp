@@ -0,0 +1,182 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Reprojection.hpp"
+
+#include <cmath>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace Reprojection
+{
+
+float3 GetPrimaryRayDirection(const float2& UV, const float3& CameraPos, const float4x4& InvViewProj)
+{
+    // Any point on the ray works; NDC depth 0.5 is inside the depth range for both D3D and GL conventions.
+    const float4 ClipPos{UV.x * 2.f - 1.f, 1.f - UV.y * 2.f, 0.5f, 1.f};
+    const float4 WorldPos = ClipPos * InvViewProj;
+    return normalize(float3{WorldPos.x, WorldPos.y, WorldPos.z} * (1.f / WorldPos.w) - CameraPos);
+}
+
+float3 ReconstructWorldPosition(const float2& UV, float HitDistance, const float3& CameraPos, const float4x4& InvViewProj)
+{
+    return CameraPos + GetPrimaryRayDirection(UV, CameraPos, InvViewProj) * HitDistance;
+}
+
+bool ProjectToScreen(const float4& WorldPos, const float4x4& ViewProj, float2& UV)
+{
+    const float4 ClipPos = WorldPos * ViewProj;
+    if (ClipPos.w <= 0)
+        return false;
+
+    UV.x = ClipPos.x / ClipPos.w * 0.5f + 0.5f;
+    UV.y = 0.5f - ClipPos.y / ClipPos.w * 0.5f;
+    return UV.x >= 0 && UV.x <= 1 && UV.y >= 0 && UV.y <= 1;
+}
+
+bool IsHistorySampleValid(const float3&                   WorldPos,
+                          const float3&                   Normal,
+                          const float3&                   PrevCameraPos,
+                          float                           PrevHitDistance,
+                          const float3&                   PrevNormal,
+                          const HistoryValidationAttribs& Validation)
+{
+    // The previous pixel saw the sky, so the surface was disoccluded.
+    if (PrevHitDistance <= 0)
+        return false;
+
+    const float ExpectedDistance = length(WorldPos - PrevCameraPos);
+    if (std::abs(ExpectedDistance - PrevHitDistance) > Validation.DepthTolerance * ExpectedDistance)
+        return false;
+
+    return dot(Normal, PrevNormal) >= Validation.NormalThreshold;
+}
+
+} // namespace Reprojection
+
+Uint32 ReprojectHistory(const ReprojectHistoryAttribs& Attribs)
+{
+    VERIFY_EXPR(Attribs.pColor != nullptr && Attribs.pSurface != nullptr && Attribs.pOutput != nullptr);
+    VERIFY_EXPR(Attribs.pPrevColor != nullptr && Attribs.pPrevSurface != nullptr);
+    VERIFY(Attribs.pOutput != Attribs.pPrevColor, "Output must not alias the history");
+
+    // Bilinear footprint below which the few remaining valid taps are considered too unreliable.
+    static constexpr float MinHistoryFootprint = 0.05f;
+
+    const Uint32 W = Attribs.Width;
+    const Uint32 H = Attribs.Height;
+
+    Uint32 NumReused = 0;
+    for (Uint32 y = 0; y < H; ++y)
+    {
+        for (Uint32 x = 0; x < W; ++x)
+        {
+            const size_t Idx = size_t{y} * W + x;
+
+            const float* pSurface    = &Attribs.pSurface[Idx * 4];
+            const float3 Normal      = {pSurface[0], pSurface[1], pSurface[2]};
+            const float  HitDistance = pSurface[3];
+            const bool   IsMiss      = HitDistance <= 0;
+
+            const float2 UV{(static_cast<float>(x) + 0.5f) / static_cast<float>(W), (static_cast<float>(y) + 0.5f) / static_cast<float>(H)};
+
+            float3 WorldPos;
+            float4 ReprojectedPos;
+            if (IsMiss)
+            {
+                ReprojectedPos = float4{Reprojection::GetPrimaryRayDirection(UV, Attribs.CameraPos, Attribs.InvViewProj), 0};
+            }
+            else
+            {
+                WorldPos       = Reprojection::ReconstructWorldPosition(UV, HitDistance, Attribs.CameraPos, Attribs.InvViewProj);
+                ReprojectedPos = float4{WorldPos, 1};
+            }
+
+            const float* pCurrColor = &Attribs.pColor[Idx * 4];
+            const float4 Current{pCurrColor[0], pCurrColor[1], pCurrColor[2], pCurrColor[3]};
+
+            float2     PrevUV;
+            const bool OnScreen = Reprojection::ProjectToScreen(ReprojectedPos, Attribs.PrevViewProj, PrevUV);
+
+            float4 History;
+            float  HistoryFootprint = 0;
+            if (OnScreen)
+            {
+                const float fx    = PrevUV.x * static_cast<float>(W) - 0.5f;
+                const float fy    = PrevUV.y * static_cast<float>(H) - 0.5f;
+                const int   x0    = static_cast<int>(std::floor(fx));
+                const int   y0    = static_cast<int>(std::floor(fy));
+                const float Wx[2] = {1.f - (fx - static_cast<float>(x0)), fx - static_cast<float>(x0)};
+                const float Wy[2] = {1.f - (fy - static_cast<float>(y0)), fy - static_cast<float>(y0)};
+
+                for (int dy = 0; dy < 2; ++dy)
+                {
+                    for (int dx = 0; dx < 2; ++dx)
+                    {
+                        const int   px     = x0 + dx;
+                        const int   py     = y0 + dy;
+                        const float Weight = Wx[dx] * Wy[dy];
+                        if (Weight <= 0 || px < 0 || py < 0 || px >= static_cast<int>(W) || py >= static_cast<int>(H))
+                            continue;
+
+                        const size_t PrevIdx      = static_cast<size_t>(py) * W + static_cast<size_t>(px);
+                        const float* pPrevSurface = &Attribs.pPrevSurface[PrevIdx * 4];
+                        const float  PrevDistance = pPrevSurface[3];
+
+                        const bool IsValid = IsMiss ?
+                            PrevDistance <= 0 :
+                            Reprojection::IsHistorySampleValid(WorldPos, Normal, Attribs.PrevCameraPos, PrevDistance,
+                                                               float3{pPrevSurface[0], pPrevSurface[1], pPrevSurface[2]},
+                                                               Attribs.Validation);
+                        if (!IsValid)
+                            continue;
+
+                        const float* pPrevColor = &Attribs.pPrevColor[PrevIdx * 4];
+                        History += float4{pPrevColor[0], pPrevColor[1], pPrevColor[2], pPrevColor[3]} * Weight;
+                        HistoryFootprint += Weight;
+                    }
+                }
+            }
+
+            float4 Result = Current;
+            if (HistoryFootprint >= MinHistoryFootprint)
+            {
+                Result = Reprojection::BlendWithHistory(Current, History * (1.f / HistoryFootprint), Attribs.HistoryWeight);
+                ++NumReused;
+            }
+
+            float* pOut = &Attribs.pOutput[Idx * 4];
+            pOut[0]     = Result.x;
+            pOut[1]     = Result.y;
+            pOut[2]     = Result.z;
+            pOut[3]     = Result.w;
+
+            if (Attribs.pMotionVectors != nullptr)
+            {
+                Attribs.pMotionVectors[Idx * 2 + 0] = OnScreen ? UV.x - PrevUV.x : 0.f;
+                Attribs.pMotionVectors[Idx * 2 + 1] = OnScreen ? UV.y - PrevUV.y : 0.f;
+            }
+        }
+    }
+
+    return NumReused;
+}
+
+} // namespace Diligent
@@ -0,0 +1,155 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include "BasicMath.hpp"
+
+namespace Diligent
+{
+
+/// Per-frame constants of temporal reuse as stored in the g_TemporalCB constant buffer.
+///
+/// Ray generation shaders write the primary hit of every pixel to the surface buffer
+/// (world-space normal in XYZ, hit distance in W) and reproject it into the previous frame
+/// with PrevViewProj. If the previous surface at that location matches (see IsHistorySampleValid),
+/// the previous shading result is blended in with HistoryWeight and secondary rays of the
+/// pixel are only traced on every SecondaryRayInterval-th frame (see IsSecondaryRayFrame).
+struct TemporalConstants
+{
+    float4x4 PrevViewProj;
+    float4   PrevCameraPos;
+
+    float  HistoryWeight        = 0.9f;
+    float  DepthTolerance       = 0.05f;
+    float  NormalThreshold      = 0.9f;
+    Uint32 SecondaryRayInterval = 4;
+
+    Uint32 FrameIndex   = 0;
+    Uint32 HistoryValid = 0; // 0 after a resize or a camera cut
+    Uint32 Padding0     = 0;
+    Uint32 Padding1     = 0;
+};
+static_assert(sizeof(TemporalConstants) % 16 == 0, "TemporalConstants must be aligned by 16 bytes");
+
+/// Surface similarity thresholds used to reject history samples.
+struct HistoryValidationAttribs
+{
+    /// Maximum relative difference between the distance from the previous camera
+    /// to the reprojected point and the hit distance stored in the previous frame.
+    float DepthTolerance = 0.05f;
+
+    /// Minimum cosine of the angle between the current and the previous normal.
+    float NormalThreshold = 0.9f;
+};
+
+/// CPU reference of the shader-side reprojection math.
+///
+/// Screen UVs are in [0, 1] with the origin in the top-left corner, matrices use the
+/// row-vector convention of BasicMath (p' = p * M). Surfaces are described by the hit
+/// distance along the primary ray rather than by the depth buffer value, which is what
+/// the ray generation shader naturally has. A non-positive hit distance marks a primary
+/// ray miss; such pixels are reprojected as directions at infinity.
+namespace Reprojection
+{
+
+/// Returns the normalized direction of the primary ray through UV.
+float3 GetPrimaryRayDirection(const float2& UV, const float3& CameraPos, const float4x4& InvViewProj);
+
+/// Reconstructs the world-space position of the primary hit of the pixel at UV.
+float3 ReconstructWorldPosition(const float2& UV, float HitDistance, const float3& CameraPos, const float4x4& InvViewProj);
+
+/// Projects the homogeneous world-space point (W = 1 for points, 0 for directions) to screen UV.
+/// Returns false if the point is behind the camera or outside of the screen.
+bool ProjectToScreen(const float4& WorldPos, const float4x4& ViewProj, float2& UV);
+
+/// Returns true if the previous-frame surface (PrevHitDistance and PrevNormal fetched at the
+/// reprojected location) is the same surface as the current one at WorldPos with Normal.
+bool IsHistorySampleValid(const float3&                   WorldPos,
+                          const float3&                   Normal,
+                          const float3&                   PrevCameraPos,
+                          float                           PrevHitDistance,
+                          const float3&                   PrevNormal,
+                          const HistoryValidationAttribs& Validation);
+
+/// Exponential moving average of the current shading result and the history.
+inline float4 BlendWithHistory(const float4& Current, const float4& History, float HistoryWeight)
+{
+    return Current * (1.f - HistoryWeight) + History * HistoryWeight;
+}
+
+/// Returns true if the pixel traces secondary rays in this frame when the history is valid.
+/// Pixels are interleaved so that every SecondaryRayInterval frames each pixel is refreshed
+/// once and 1/SecondaryRayInterval of the secondary rays is traced per frame.
+inline bool IsSecondaryRayFrame(Uint32 X, Uint32 Y, Uint32 FrameIndex, Uint32 SecondaryRayInterval)
+{
+    return SecondaryRayInterval <= 1 || (X + Y * 3u + FrameIndex) % SecondaryRayInterval == 0;
+}
+
+} // namespace Reprojection
+
+
+/// Images for ReprojectHistory(). All images are tightly packed, row-major, Width * Height pixels.
+struct ReprojectHistoryAttribs
+{
+    Uint32 Width  = 0;
+    Uint32 Height = 0;
+
+    float3   CameraPos;
+    float4x4 InvViewProj;
+    float3   PrevCameraPos;
+    float4x4 PrevViewProj;
+
+    /// Current shading result, 4 floats (RGBA) per pixel.
+    const float* pColor = nullptr;
+
+    /// Current surface, 4 floats per pixel: world-space normal in XYZ, hit distance in W.
+    const float* pSurface = nullptr;
+
+    /// Previous-frame shading result and surface in the same formats.
+    const float* pPrevColor   = nullptr;
+    const float* pPrevSurface = nullptr;
+
+    float HistoryWeight = 0.9f;
+
+    HistoryValidationAttribs Validation;
+
+    /// Output color, 4 floats per pixel. May alias pColor, but not pPrevColor.
+    float* pOutput = nullptr;
+
+    /// Optional output motion vectors, 2 floats per pixel (current minus previous UV).
+    /// Pixels that reproject outside of the previous frame get zero motion.
+    float* pMotionVectors = nullptr;
+};
+
+/// CPU reference of temporal reuse: reprojects every pixel into the previous frame,
+/// fetches the history with bilinear filtering where each of the four taps is validated
+/// against the current surface, and blends the valid history with the current color.
+/// Returns the number of pixels that reused history.
+Uint32 ReprojectHistory(const ReprojectHistoryAttribs& Attribs);
+
+} // namespace Diligent
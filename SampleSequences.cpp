@@ -0,0 +1,214 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "SampleSequences.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace SampleSequence
+{
+
+float2 SquareToConcentricDisc(const float2& u)
+{
+    const float a = 2.f * u.x - 1.f;
+    const float b = 2.f * u.y - 1.f;
+    if (a == 0 && b == 0)
+        return float2{0, 0};
+
+    float r, phi;
+    if (std::abs(a) > std::abs(b))
+    {
+        r   = a;
+        phi = (PI_F / 4.f) * (b / a);
+    }
+    else
+    {
+        r   = b;
+        phi = (PI_F / 2.f) - (PI_F / 4.f) * (a / b);
+    }
+    return float2{r * std::cos(phi), r * std::sin(phi)};
+}
+
+void GenerateBlueNoise(Uint32 Size, std::vector<Uint16>& Ranks, float Sigma, Uint32 Seed)
+{
+    VERIFY(Size > 0 && Size <= 256, "Blue noise texture size must be in [1, 256]");
+
+    const Uint32 NumTexels = Size * Size;
+
+    // Gaussian energy of a texel at toroidal offset (dx, dy).
+    std::vector<float> EnergyLUT(NumTexels);
+    for (Uint32 dy = 0; dy < Size; ++dy)
+    {
+        for (Uint32 dx = 0; dx < Size; ++dx)
+        {
+            const float x = static_cast<float>(std::min(dx, Size - dx));
+            const float y = static_cast<float>(std::min(dy, Size - dy));
+
+            EnergyLUT[dy * Size + dx] = std::exp(-(x * x + y * y) / (2.f * Sigma * Sigma));
+        }
+    }
+
+    std::vector<Uint8> Pattern(NumTexels, 0);
+    std::vector<float> Energy(NumTexels, 0.f);
+
+    auto Splat = [&](std::vector<float>& Field, Uint32 Texel, float Sign) {
+        const Uint32 tx = Texel % Size;
+        const Uint32 ty = Texel / Size;
+        for (Uint32 y = 0; y < Size; ++y)
+        {
+            const Uint32 dy = (y + Size - ty) % Size;
+            for (Uint32 x = 0; x < Size; ++x)
+            {
+                const Uint32 dx = (x + Size - tx) % Size;
+                Field[y * Size + x] += Sign * EnergyLUT[dy * Size + dx];
+            }
+        }
+    };
+
+    // Tightest cluster: the set texel with the highest energy.
+    // Largest void: the empty texel with the lowest energy.
+    auto FindExtremum = [&](const std::vector<float>& Field, Uint8 Value, bool FindMax) {
+        Uint32 Best      = ~0u;
+        float  BestValue = 0;
+        for (Uint32 i = 0; i < NumTexels; ++i)
+        {
+            if (Pattern[i] != Value)
+                continue;
+            if (Best == ~0u || (FindMax ? Field[i] > BestValue : Field[i] < BestValue))
+            {
+                Best      = i;
+                BestValue = Field[i];
+            }
+        }
+        return Best;
+    };
+
+    // Initial binary pattern: ~10% randomly placed texels.
+    Uint32       Rng         = Seed != 0 ? Seed : 1;
+    const Uint32 NumInitial  = std::max(NumTexels / 10, 1u);
+    Uint32       NumSet      = 0;
+    while (NumSet < NumInitial)
+    {
+        // xorshift32
+        Rng ^= Rng << 13u;
+        Rng ^= Rng >> 17u;
+        Rng ^= Rng << 5u;
+        const Uint32 Texel = Rng % NumTexels;
+        if (Pattern[Texel] == 0)
+        {
+            Pattern[Texel] = 1;
+            Splat(Energy, Texel, +1.f);
+            ++NumSet;
+        }
+    }
+
+    // Relax the initial pattern by moving the tightest cluster into the largest void
+    // until the two coincide.
+    for (Uint32 Iter = 0; Iter < NumTexels; ++Iter)
+    {
+        const Uint32 Cluster = FindExtremum(Energy, 1, true);
+        Pattern[Cluster]     = 0;
+        Splat(Energy, Cluster, -1.f);
+
+        const Uint32 Void = FindExtremum(Energy, 0, false);
+        Pattern[Void]     = 1;
+        Splat(Energy, Void, +1.f);
+
+        if (Void == Cluster)
+            break;
+    }
+
+    Ranks.assign(NumTexels, 0);
+
+    const std::vector<Uint8> Prototype       = Pattern;
+    const std::vector<float> PrototypeEnergy = Energy;
+
+    // Phase 1: remove the tightest clusters from the prototype, ranking them in decreasing order.
+    for (Uint32 Rank = NumSet; Rank > 0; --Rank)
+    {
+        const Uint32 Cluster = FindExtremum(Energy, 1, true);
+        Pattern[Cluster]     = 0;
+        Splat(Energy, Cluster, -1.f);
+        Ranks[Cluster] = static_cast<Uint16>(Rank - 1);
+    }
+
+    // Phase 2: fill the largest voids up to half of the texels.
+    Pattern = Prototype;
+    Energy  = PrototypeEnergy;
+    Uint32 Rank = NumSet;
+    for (; Rank < NumTexels / 2; ++Rank)
+    {
+        const Uint32 Void = FindExtremum(Energy, 0, false);
+        Pattern[Void]     = 1;
+        Splat(Energy, Void, +1.f);
+        Ranks[Void] = static_cast<Uint16>(Rank);
+    }
+
+    // Phase 3: empty texels are now the minority, so rank the tightest clusters of empty texels.
+    std::vector<float> EmptyEnergy(NumTexels, 0.f);
+    for (Uint32 i = 0; i < NumTexels; ++i)
+    {
+        if (Pattern[i] == 0)
+            Splat(EmptyEnergy, i, +1.f);
+    }
+    for (; Rank < NumTexels; ++Rank)
+    {
+        const Uint32 Cluster = FindExtremum(EmptyEnergy, 0, true);
+        Pattern[Cluster]     = 1;
+        Splat(EmptyEnergy, Cluster, -1.f);
+        Ranks[Cluster] = static_cast<Uint16>(Rank);
+    }
+}
+
+double ComputeL2StarDiscrepancy(const float2* pPoints, size_t NumPoints)
+{
+    if (NumPoints == 0)
+        return 0;
+
+    const double N = static_cast<double>(NumPoints);
+
+    double Sum1 = 0;
+    for (size_t i = 0; i < NumPoints; ++i)
+    {
+        const double x = pPoints[i].x;
+        const double y = pPoints[i].y;
+        Sum1 += (1.0 - x * x) * (1.0 - y * y);
+    }
+
+    double Sum2 = 0;
+    for (size_t i = 0; i < NumPoints; ++i)
+    {
+        for (size_t j = 0; j < NumPoints; ++j)
+        {
+            Sum2 += (1.0 - std::max<double>(pPoints[i].x, pPoints[j].x)) *
+                (1.0 - std::max<double>(pPoints[i].y, pPoints[j].y));
+        }
+    }
+
+    const double D2 = 1.0 / 9.0 - Sum1 / (2.0 * N) + Sum2 / (N * N);
+    return std::sqrt(std::max(D2, 0.0));
+}
+
+} // namespace SampleSequence
+
+} // namespace Diligent
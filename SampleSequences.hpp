@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+// Low-discrepancy and blue-noise sample sequences.
+
+#include <cstddef>
+#include <vector>
+
+#include "BasicMath.hpp"
+
+namespace Diligent
+{
+
+namespace SampleSequence
+{
+
+/// Reverses the bits of a 32-bit value.
+constexpr Uint32 ReverseBits(Uint32 x)
+{
+    x = ((x >> 1u) & 0x55555555u) | ((x & 0x55555555u) << 1u);
+    x = ((x >> 2u) & 0x33333333u) | ((x & 0x33333333u) << 2u);
+    x = ((x >> 4u) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4u);
+    x = ((x >> 8u) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8u);
+    return (x >> 16u) | (x << 16u);
+}
+
+/// First two dimensions of the Sobol sequence as 32-bit fixed-point values.
+/// Dimension 0 is the van der Corput sequence; dimension 1 uses the direction
+/// numbers of the primitive polynomial x + 1.
+constexpr Uint32 Sobol(Uint32 Index, Uint32 Dim)
+{
+    if (Dim == 0)
+        return ReverseBits(Index);
+
+    Uint32 Result = 0;
+    for (Uint32 v = 1u << 31u; Index != 0; Index >>= 1u, v ^= v >> 1u)
+    {
+        if (Index & 1u)
+            Result ^= v;
+    }
+    return Result;
+}
+
+/// Laine-Karras style hash-based Owen scrambling of a 32-bit fixed-point sample
+/// (Burley 2020, "Practical Hash-based Owen Scrambling").
+constexpr Uint32 OwenScramble(Uint32 x, Uint32 Seed)
+{
+    x = ReverseBits(x);
+    x ^= x * 0x3D20ADEAu;
+    x += Seed;
+    x *= (Seed >> 16u) | 1u;
+    x ^= x * 0x05526C56u;
+    x ^= x * 0x53A22864u;
+    return ReverseBits(x);
+}
+
+/// Mixes a pixel position and a frame index into a scrambling seed.
+constexpr Uint32 HashSeed(Uint32 x, Uint32 y, Uint32 Frame)
+{
+    Uint32 h = x * 0x8DA6B343u ^ y * 0xD8163841u ^ Frame * 0xCB1AB31Fu;
+    h ^= h >> 16u;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15u;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16u;
+    return h;
+}
+
+/// Converts a 32-bit fixed-point sample to a float in [0, 1).
+constexpr float ToUnitFloat(Uint32 x)
+{
+    // Keep the 24 most significant bits so that the result is exactly representable.
+    return static_cast<float>(x >> 8u) * (1.f / 16777216.f);
+}
+
+static_assert(ReverseBits(1u) == 0x80000000u, "ReverseBits is broken");
+static_assert(Sobol(1, 0) == 0x80000000u && Sobol(2, 0) == 0x40000000u && Sobol(3, 0) == 0xC0000000u, "Sobol dimension 0 is broken");
+static_assert(Sobol(1, 1) == 0x80000000u && Sobol(2, 1) == 0xC0000000u && Sobol(3, 1) == 0x40000000u, "Sobol dimension 1 is broken");
+
+/// Maps a point in [0, 1)^2 to the unit disc with Shirley-Chiu concentric mapping.
+/// The square center maps to the disc center.
+float2 SquareToConcentricDisc(const float2& u);
+
+/// Generates a Size x Size tileable blue-noise rank texture with the void-and-cluster
+/// method (Ulichney 1993). Each texel receives a unique rank in [0, Size*Size).
+/// Sigma is the standard deviation of the Gaussian energy filter in texels.
+void GenerateBlueNoise(Uint32 Size, std::vector<Uint16>& Ranks, float Sigma = 1.9f, Uint32 Seed = 1);
+
+/// Computes the L2-star discrepancy of 2D points in [0, 1)^2 with Warnock's formula.
+/// Lower is better; random points are O(1/sqrt(N)), low-discrepancy sequences approach O(log(N)/N).
+double ComputeL2StarDiscrepancy(const float2* pPoints, size_t NumPoints);
+
+} // namespace SampleSequence
+
+} // namespace Diligent
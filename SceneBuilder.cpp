@@ -0,0 +1,160 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "SceneBuilder.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+namespace Diligent
+{
+
+void InstanceNameTable::Init(const char* Prefix, Uint32 Count)
+{
+    m_Storage.clear();
+    m_Offsets.clear();
+    m_Offsets.reserve(Count);
+
+    // Prefix, space, up to 10 digits and the null terminator.
+    const size_t MaxNameLen = std::strlen(Prefix) + 12;
+    m_Storage.reserve(MaxNameLen * Count);
+
+    char Name[128];
+    for (Uint32 i = 0; i < Count; ++i)
+    {
+        const int Len = std::snprintf(Name, sizeof(Name), "%s %u", Prefix, i + 1);
+        VERIFY_EXPR(Len > 0 && static_cast<size_t>(Len) < sizeof(Name));
+        m_Offsets.push_back(static_cast<Uint32>(m_Storage.size()));
+        m_Storage.insert(m_Storage.end(), Name, Name + Len + 1);
+    }
+}
+
+void WriteSceneInstances(const SceneInstanceAttribs& Attribs, TLASBuildInstanceData* pInstances)
+{
+    VERIFY_EXPR(Attribs.pCubeNames != nullptr && Attribs.pSphereNames != nullptr);
+
+    const Uint32 NumCubes   = Attribs.pCubeNames->GetCount();
+    const Uint32 NumSpheres = Attribs.pSphereNames->GetCount();
+    const float  AnimTime   = Attribs.AnimationTime;
+
+    // Cubes around circle
+    for (Uint32 i = 0; i < NumCubes; ++i)
+    {
+        auto& inst        = pInstances[i];
+        inst.InstanceName = Attribs.pCubeNames->GetName(i);
+        inst.CustomId     = i % Attribs.NumTextures;
+        inst.pBLAS        = Attribs.pCubeBLAS;
+        inst.Mask         = OPAQUE_GEOM_MASK;
+        float angle       = 2 * PI_F * static_cast<float>(i) / static_cast<float>(NumCubes);
+        float radius      = 5.0f;
+        float x           = std::cos(angle) * radius;
+        float y           = std::sin(AnimTime + static_cast<float>(i)) * 1.0f;
+        float z           = std::sin(angle) * radius;
+        inst.Transform.SetTranslation(x, y, z);
+        inst.Transform.SetRotation(float3x3::RotationY(angle + AnimTime).Data());
+    }
+
+    // Spheres around larger circle
+    for (Uint32 i = 0; i < NumSpheres; ++i)
+    {
+        auto& inst        = pInstances[NumCubes + i];
+        inst.InstanceName = Attribs.pSphereNames->GetName(i);
+        inst.CustomId     = 0;
+        inst.pBLAS        = Attribs.pProceduralBLAS;
+        inst.Mask         = OPAQUE_GEOM_MASK;
+        float angle       = 2 * PI_F * static_cast<float>(i) / static_cast<float>(NumSpheres);
+        float radius      = 7.0f;
+        float x           = std::cos(angle) * radius;
+        float z           = std::sin(angle) * radius;
+        inst.Transform.SetTranslation(x, -2.0f, z);
+    }
+
+    // Ground
+    {
+        auto& g        = pInstances[NumCubes + NumSpheres];
+        g.InstanceName = GroundInstanceName;
+        g.pBLAS        = Attribs.pCubeBLAS;
+        g.Mask         = OPAQUE_GEOM_MASK;
+        g.Transform.SetRotation(float3x3::Scale(100.0f, 0.1f, 100.0f).Data());
+        g.Transform.SetTranslation(0.0f, -6.0f, 0.0f);
+    }
+
+    // Glass cube
+    {
+        auto& gl        = pInstances[NumCubes + NumSpheres + 1];
+        gl.InstanceName = GlassInstanceName;
+        gl.pBLAS        = Attribs.pCubeBLAS;
+        gl.Mask         = TRANSPARENT_GEOM_MASK;
+        gl.Transform.SetRotation(
+            (float3x3::Scale(1.5f, 1.5f, 1.5f) *
+             float3x3::RotationY(AnimTime * PI_F * 0.25f))
+                .Data());
+        gl.Transform.SetTranslation(3.0f, -4.0f, -5.0f);
+    }
+}
+
+void BuildCubeAttribs(const CubeVertex* pVertices,
+                      Uint32            NumVertices,
+                      const Uint32*     pIndices,
+                      Uint32            NumIndices,
+                      HLSL::CubeAttribs& Attribs)
+{
+    VERIFY_EXPR(NumVertices <= std::size(Attribs.UVs) && NumIndices / 3 <= std::size(Attribs.Primitives));
+
+    for (Uint32 v = 0; v < NumVertices; ++v)
+    {
+        Attribs.UVs[v]     = {pVertices[v].UV, 0, 0};
+        Attribs.Normals[v] = pVertices[v].Normal;
+    }
+    for (Uint32 i = 0; i < NumIndices; i += 3)
+    {
+        const Uint32* tri         = &pIndices[i];
+        Attribs.Primitives[i / 3] = uint4{tri[0], tri[1], tri[2], 0};
+    }
+}
+
+void UpdateCameraConstants(const float3& CameraPos, const float4x4& ViewProj, HLSL::Constants& Constants)
+{
+    Constants.CameraPos   = float4{CameraPos, 1.0f};
+    Constants.InvViewProj = ViewProj.Inverse();
+}
+
+void WriteHitGroupBindings(const InstanceNameTable&      CubeNames,
+                           const InstanceNameTable&      SphereNames,
+                           std::vector<HitGroupBinding>& Bindings)
+{
+    Bindings.clear();
+    Bindings.reserve(CubeNames.GetCount() + SphereNames.GetCount() * 2 + 2);
+
+    for (Uint32 i = 0; i < CubeNames.GetCount(); ++i)
+        Bindings.push_back({CubeNames.GetName(i), PRIMARY_RAY_INDEX, "CubePrimaryHit"});
+
+    for (Uint32 i = 0; i < SphereNames.GetCount(); ++i)
+        Bindings.push_back({SphereNames.GetName(i), PRIMARY_RAY_INDEX, "SpherePrimaryHit"});
+
+    Bindings.push_back({GroundInstanceName, PRIMARY_RAY_INDEX, "GroundHit"});
+    Bindings.push_back({GlassInstanceName, PRIMARY_RAY_INDEX, "GlassPrimaryHit"});
+
+    // Shadow rays only need an intersection shader for procedural geometry,
+    // all other instances use the default (empty) shadow hit group.
+    for (Uint32 i = 0; i < SphereNames.GetCount(); ++i)
+        Bindings.push_back({SphereNames.GetName(i), SHADOW_RAY_INDEX, "SphereShadowHit"});
+}
+
+} // namespace Diligent
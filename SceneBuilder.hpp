@@ -0,0 +1,120 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+// CPU-side parts of the frame that don't require a render device.
+// They are shared by the sample and the benchmarks (see Tutorial21_Benchmarks.cpp).
+
+#include <vector>
+
+#include "DeviceContext.h"
+#include "BasicMath.hpp"
+#include "DebugUtilities.hpp"
+#include "ShaderStructures.hpp"
+
+namespace Diligent
+{
+
+struct CubeVertex
+{
+    float3 Pos;
+    float3 Normal;
+    float2 UV;
+};
+
+/// Stores instance names ("<Prefix> 1", "<Prefix> 2", ...) in a single contiguous buffer.
+/// The names are generated once, so TLAS and SBT updates don't need to format strings.
+class InstanceNameTable
+{
+public:
+    void Init(const char* Prefix, Uint32 Count);
+
+    const char* GetName(Uint32 Index) const
+    {
+        VERIFY_EXPR(Index < m_Offsets.size());
+        return &m_Storage[m_Offsets[Index]];
+    }
+
+    Uint32 GetCount() const { return static_cast<Uint32>(m_Offsets.size()); }
+
+    size_t GetStorageSize() const { return m_Storage.size(); }
+
+private:
+    std::vector<char>   m_Storage;
+    std::vector<Uint32> m_Offsets;
+};
+
+struct SceneInstanceAttribs
+{
+    IBottomLevelAS* pCubeBLAS       = nullptr;
+    IBottomLevelAS* pProceduralBLAS = nullptr;
+
+    /// Names of the cube and sphere instances; the number of names defines the instance counts.
+    const InstanceNameTable* pCubeNames   = nullptr;
+    const InstanceNameTable* pSphereNames = nullptr;
+
+    Uint32 NumTextures   = 1;
+    float  AnimationTime = 0;
+};
+
+static constexpr char GroundInstanceName[] = "Ground Instance";
+static constexpr char GlassInstanceName[]  = "Glass Instance";
+
+/// Returns the total number of TLAS instances: cubes, spheres, ground and glass cube.
+inline Uint32 GetSceneInstanceCount(Uint32 NumCubes, Uint32 NumSpheres)
+{
+    return NumCubes + NumSpheres + 2;
+}
+
+/// Writes all scene instances to pInstances, which must hold GetSceneInstanceCount() elements.
+void WriteSceneInstances(const SceneInstanceAttribs& Attribs, TLASBuildInstanceData* pInstances);
+
+/// Builds the cube attributes (UVs, normals and primitive indices) used by the cube hit shader.
+void BuildCubeAttribs(const CubeVertex* pVertices,
+                      Uint32            NumVertices,
+                      const Uint32*     pIndices,
+                      Uint32            NumIndices,
+                      HLSL::CubeAttribs& Attribs);
+
+/// Writes per-frame camera data to the shader constants.
+void UpdateCameraConstants(const float3& CameraPos, const float4x4& ViewProj, HLSL::Constants& Constants);
+
+struct HitGroupBinding
+{
+    const char* InstanceName = nullptr;
+    Uint32      RayIndex     = 0;
+    const char* HitGroupName = nullptr;
+};
+
+/// Generates per-instance hit group bindings for the shader binding table.
+/// Bindings is cleared and refilled; its capacity is reused between calls.
+void WriteHitGroupBindings(const InstanceNameTable&      CubeNames,
+                           const InstanceNameTable&      SphereNames,
+                           std::vector<HitGroupBinding>& Bindings);
+
+} // namespace Diligent
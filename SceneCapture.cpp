@@ -0,0 +1,173 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "SceneCapture.hpp"
+
+#include <cstring>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+bool SceneCaptureWriter::Open(const char* FilePath, Uint32 Width, Uint32 Height, Uint32 ConstantsSize)
+{
+    VERIFY_EXPR(FilePath != nullptr && ConstantsSize > 0);
+
+    m_File.open(FilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_File)
+    {
+        LOG_ERROR_MESSAGE("Failed to open capture file '", FilePath, "' for writing");
+        return false;
+    }
+
+    SceneCaptureHeader Header;
+    Header.Width         = Width;
+    Header.Height        = Height;
+    Header.ConstantsSize = ConstantsSize;
+    m_File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+
+    m_LastConstants.assign(ConstantsSize, 0);
+    m_HasConstants = false;
+    m_FrameCount   = 0;
+    m_Width        = Width;
+    m_Height       = Height;
+    return true;
+}
+
+void SceneCaptureWriter::Close()
+{
+    if (!m_File.is_open())
+        return;
+
+    m_File.close();
+    LOG_INFO_MESSAGE("Recorded ", m_FrameCount, " frames");
+}
+
+void SceneCaptureWriter::WriteFrame(float AnimationTime, const float3& CameraPos, const float4x4& ViewMatrix, const void* pConstants)
+{
+    if (!m_File.is_open())
+        return;
+
+    const bool ConstantsChanged = !m_HasConstants || std::memcmp(m_LastConstants.data(), pConstants, m_LastConstants.size()) != 0;
+
+    SceneCaptureFrameHeader Frame;
+    Frame.Flags         = ConstantsChanged ? SCENE_CAPTURE_FRAME_FLAG_CONSTANTS : SCENE_CAPTURE_FRAME_FLAG_NONE;
+    Frame.AnimationTime = AnimationTime;
+    Frame.CameraPos     = CameraPos;
+    Frame.ViewMatrix    = ViewMatrix;
+    m_File.write(reinterpret_cast<const char*>(&Frame), sizeof(Frame));
+
+    if (ConstantsChanged)
+    {
+        std::memcpy(m_LastConstants.data(), pConstants, m_LastConstants.size());
+        m_File.write(reinterpret_cast<const char*>(pConstants), m_LastConstants.size());
+        m_HasConstants = true;
+    }
+
+    ++m_FrameCount;
+}
+
+
+bool SceneCaptureReader::Open(const char* FilePath, Uint32 ExpectedConstantsSize)
+{
+    VERIFY_EXPR(FilePath != nullptr);
+
+    std::ifstream File{FilePath, std::ios::in | std::ios::binary | std::ios::ate};
+    if (!File)
+    {
+        LOG_ERROR_MESSAGE("Failed to open capture file '", FilePath, "'");
+        return false;
+    }
+
+    const std::streamoff FileSize = File.tellg();
+    if (FileSize < static_cast<std::streamoff>(sizeof(SceneCaptureHeader)))
+    {
+        LOG_ERROR_MESSAGE("Capture file '", FilePath, "' is too small");
+        return false;
+    }
+
+    std::vector<Uint8> Data(static_cast<size_t>(FileSize));
+    File.seekg(0);
+    File.read(reinterpret_cast<char*>(Data.data()), FileSize);
+    if (!File)
+    {
+        LOG_ERROR_MESSAGE("Failed to read capture file '", FilePath, "'");
+        return false;
+    }
+
+    SceneCaptureHeader Header;
+    std::memcpy(&Header, Data.data(), sizeof(Header));
+    if (Header.Magic != SceneCaptureMagic || Header.Version != SceneCaptureVersion)
+    {
+        LOG_ERROR_MESSAGE("'", FilePath, "' is not a valid capture file");
+        return false;
+    }
+    if (Header.ConstantsSize != ExpectedConstantsSize)
+    {
+        LOG_ERROR_MESSAGE("Capture file '", FilePath, "' was recorded with a different constants layout (",
+                          Header.ConstantsSize, " bytes vs ", ExpectedConstantsSize, " bytes expected)");
+        return false;
+    }
+    if (Header.Width == 0 || Header.Height == 0)
+    {
+        LOG_ERROR_MESSAGE("Capture file '", FilePath, "' has invalid resolution");
+        return false;
+    }
+
+    // Count the frames up front so that per-frame storage can be reserved before replay starts.
+    Uint32 FrameCount = 0;
+    for (size_t Offset = sizeof(SceneCaptureHeader); Offset + sizeof(SceneCaptureFrameHeader) <= Data.size(); ++FrameCount)
+    {
+        Uint32 Flags = 0;
+        std::memcpy(&Flags, &Data[Offset], sizeof(Flags));
+        Offset += sizeof(SceneCaptureFrameHeader);
+        if ((Flags & SCENE_CAPTURE_FRAME_FLAG_CONSTANTS) != 0)
+            Offset += Header.ConstantsSize;
+    }
+
+    m_Header     = Header;
+    m_Data       = std::move(Data);
+    m_Offset     = sizeof(SceneCaptureHeader);
+    m_FrameCount = FrameCount;
+    return true;
+}
+
+bool SceneCaptureReader::ReadFrame(SceneCaptureFrameHeader& Frame, void* pConstants)
+{
+    if (m_Offset + sizeof(Frame) > m_Data.size())
+        return false;
+
+    std::memcpy(&Frame, &m_Data[m_Offset], sizeof(Frame));
+    m_Offset += sizeof(Frame);
+
+    if ((Frame.Flags & SCENE_CAPTURE_FRAME_FLAG_CONSTANTS) != 0)
+    {
+        if (m_Offset + m_Header.ConstantsSize > m_Data.size())
+        {
+            LOG_ERROR_MESSAGE("Capture file is truncated");
+            m_Offset = m_Data.size();
+            return false;
+        }
+        std::memcpy(pConstants, &m_Data[m_Offset], m_Header.ConstantsSize);
+        m_Offset += m_Header.ConstantsSize;
+    }
+
+    return true;
+}
+
+} // namespace Diligent
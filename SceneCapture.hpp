@@ -0,0 +1,138 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <fstream>
+#include <vector>
+
+#include "BasicMath.hpp"
+
+namespace Diligent
+{
+
+// Binary capture file layout (little-endian):
+//
+//   SceneCaptureHeader
+//   Frame record 0
+//   Frame record 1
+//   ...
+//
+// Every frame record starts with SceneCaptureFrameHeader. If its Flags contain
+// SCENE_CAPTURE_FRAME_FLAG_CONSTANTS, it is followed by ConstantsSize bytes with
+// the new shader constants. Constants are only stored when they change, so a
+// capture of a camera fly-through without UI interaction is ~100 bytes per frame.
+
+static constexpr Uint32 SceneCaptureMagic   = 0x43313254; // 'T21C'
+static constexpr Uint32 SceneCaptureVersion = 3;
+
+enum SCENE_CAPTURE_FRAME_FLAGS : Uint32
+{
+    SCENE_CAPTURE_FRAME_FLAG_NONE      = 0u,
+    SCENE_CAPTURE_FRAME_FLAG_CONSTANTS = 1u << 0u,
+};
+
+struct SceneCaptureHeader
+{
+    Uint32 Magic         = SceneCaptureMagic;
+    Uint32 Version       = SceneCaptureVersion;
+    Uint32 Width         = 0;
+    Uint32 Height        = 0;
+    Uint32 ConstantsSize = 0;
+    Uint32 Reserved      = 0;
+};
+static_assert(sizeof(SceneCaptureHeader) == 24, "Capture header layout must not change");
+
+struct SceneCaptureFrameHeader
+{
+    Uint32   Flags         = SCENE_CAPTURE_FRAME_FLAG_NONE;
+    float    AnimationTime = 0;
+    float3   CameraPos;
+    float4x4 ViewMatrix;
+};
+static_assert(sizeof(SceneCaptureFrameHeader) == 84, "Capture frame layout must not change");
+
+
+/// Records per-frame camera pose, animation time and shader constant changes into a capture file.
+class SceneCaptureWriter
+{
+public:
+    bool Open(const char* FilePath, Uint32 Width, Uint32 Height, Uint32 ConstantsSize);
+    void Close();
+
+    bool IsOpen() const { return m_File.is_open(); }
+
+    /// Appends a frame. pConstants must point to ConstantsSize bytes; they are
+    /// only written to the file if they differ from the previously recorded values.
+    /// Per-frame data such as the camera matrices must be excluded from pConstants
+    /// by the caller, otherwise every frame will store the full constant block.
+    void WriteFrame(float AnimationTime, const float3& CameraPos, const float4x4& ViewMatrix, const void* pConstants);
+
+    Uint32 GetFrameCount() const { return m_FrameCount; }
+    Uint32 GetWidth() const { return m_Width; }
+    Uint32 GetHeight() const { return m_Height; }
+
+private:
+    std::ofstream      m_File;
+    std::vector<Uint8> m_LastConstants;
+    bool               m_HasConstants = false;
+    Uint32             m_FrameCount   = 0;
+    Uint32             m_Width        = 0;
+    Uint32             m_Height       = 0;
+};
+
+
+/// Reads a capture file produced by SceneCaptureWriter.
+/// The whole file is loaded into memory on Open() so that replay does not perform
+/// any file IO while frames are being timed.
+class SceneCaptureReader
+{
+public:
+    bool Open(const char* FilePath, Uint32 ExpectedConstantsSize);
+
+    /// Reads the next frame. If the frame contains new constants, they are copied to
+    /// pConstants and SCENE_CAPTURE_FRAME_FLAG_CONSTANTS is set in Frame.Flags.
+    /// Returns false when the end of the capture is reached or the data is corrupt.
+    bool ReadFrame(SceneCaptureFrameHeader& Frame, void* pConstants);
+
+    bool IsOpen() const { return !m_Data.empty(); }
+    bool IsEnd() const { return m_Offset >= m_Data.size(); }
+
+    Uint32 GetWidth() const { return m_Header.Width; }
+    Uint32 GetHeight() const { return m_Header.Height; }
+
+    /// Upper bound on the number of frames ReadFrame() will return; a truncated last frame is included.
+    Uint32 GetFrameCount() const { return m_FrameCount; }
+
+private:
+    std::vector<Uint8> m_Data;
+    size_t             m_Offset = 0;
+    SceneCaptureHeader m_Header;
+    Uint32             m_FrameCount = 0;
+};
+
+} // namespace Diligent
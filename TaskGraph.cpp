@@ -0,0 +1,174 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "TaskGraph.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+TaskGraph::TaskId TaskGraph::AddTask(const char* Name, std::function<void()> Func, std::initializer_list<TaskId> Dependencies)
+{
+    const TaskId Id = static_cast<TaskId>(m_Tasks.size());
+
+    Task NewTask;
+    NewTask.Name            = Name;
+    NewTask.Func            = std::move(Func);
+    NewTask.NumDependencies = static_cast<Uint32>(Dependencies.size());
+    for (TaskId Dep : Dependencies)
+    {
+        VERIFY(Dep < Id, "Task '", Name, "' depends on a task that has not been added yet");
+        m_Tasks[Dep].Dependents.push_back(Id);
+    }
+    m_Tasks.emplace_back(std::move(NewTask));
+
+    return Id;
+}
+
+void TaskGraph::Run(Uint32 NumThreads)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const Uint32 NumTasks = static_cast<Uint32>(m_Tasks.size());
+    m_Timings.assign(NumTasks, {});
+    if (NumTasks == 0)
+        return;
+
+    if (NumThreads == 0)
+        NumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    NumThreads = std::min(NumThreads, NumTasks);
+
+    std::mutex              Mtx;
+    std::condition_variable CV;
+    std::vector<TaskId>     ReadyTasks;
+    std::vector<Uint32>     RemainingDeps(NumTasks);
+    Uint32                  NumUnfinished = NumTasks;
+    Uint32                  NumRunning    = 0;
+    std::exception_ptr      Error;
+
+    for (TaskId Id = 0; Id < NumTasks; ++Id)
+    {
+        RemainingDeps[Id] = m_Tasks[Id].NumDependencies;
+        if (RemainingDeps[Id] == 0)
+            ReadyTasks.push_back(Id);
+    }
+    // Start tasks in the order they were added.
+    std::reverse(ReadyTasks.begin(), ReadyTasks.end());
+
+    const auto StartTime = Clock::now();
+
+    auto Worker = [&](Uint32 WorkerId) {
+        std::unique_lock<std::mutex> Lock{Mtx};
+        while (true)
+        {
+            // After an error, only wait for the running tasks to finish.
+            CV.wait(Lock, [&]() { return !ReadyTasks.empty() || NumUnfinished == 0 || (Error && NumRunning == 0); });
+            if (ReadyTasks.empty() || Error)
+            {
+                CV.notify_all();
+                return;
+            }
+
+            const TaskId Id = ReadyTasks.back();
+            ReadyTasks.pop_back();
+            ++NumRunning;
+            Lock.unlock();
+
+            std::exception_ptr TaskError;
+            const auto         TaskStart = Clock::now();
+            try
+            {
+                m_Tasks[Id].Func();
+            }
+            catch (...)
+            {
+                TaskError = std::current_exception();
+            }
+            const auto TaskEnd = Clock::now();
+
+            TaskTiming& Timing = m_Timings[Id];
+            Timing.Name        = m_Tasks[Id].Name;
+            Timing.StartMs     = std::chrono::duration<double, std::milli>(TaskStart - StartTime).count();
+            Timing.DurationMs  = std::chrono::duration<double, std::milli>(TaskEnd - TaskStart).count();
+            Timing.WorkerId    = WorkerId;
+
+            Lock.lock();
+            --NumRunning;
+            --NumUnfinished;
+            if (TaskError)
+            {
+                if (!Error)
+                    Error = TaskError;
+            }
+            else
+            {
+                for (TaskId Dependent : m_Tasks[Id].Dependents)
+                {
+                    if (--RemainingDeps[Dependent] == 0)
+                        ReadyTasks.push_back(Dependent);
+                }
+            }
+            CV.notify_all();
+        }
+    };
+
+    std::vector<std::thread> Threads;
+    Threads.reserve(NumThreads - 1);
+    for (Uint32 i = 1; i < NumThreads; ++i)
+        Threads.emplace_back(Worker, i);
+    Worker(0);
+    for (std::thread& Thread : Threads)
+        Thread.join();
+
+    m_TotalTimeMs = std::chrono::duration<double, std::milli>(Clock::now() - StartTime).count();
+
+    if (Error)
+        std::rethrow_exception(Error);
+}
+
+void TaskGraph::LogTimings(const char* Title) const
+{
+    double SerialTimeMs = 0;
+    for (const TaskTiming& Timing : m_Timings)
+        SerialTimeMs += Timing.DurationMs;
+
+    char Header[128];
+    std::snprintf(Header, sizeof(Header), " (wall time %.2f ms, sum of tasks %.2f ms):", m_TotalTimeMs, SerialTimeMs);
+
+    std::string Report = Title;
+    Report += Header;
+
+    for (const TaskTiming& Timing : m_Timings)
+    {
+        char Line[256];
+        std::snprintf(Line, sizeof(Line), "\n  %-24s worker %2u  start %8.2f ms  duration %8.2f ms",
+                      Timing.Name.c_str(), Timing.WorkerId, Timing.StartMs, Timing.DurationMs);
+        Report += Line;
+    }
+    LOG_INFO_MESSAGE(Report);
+}
+
+} // namespace Diligent
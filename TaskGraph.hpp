@@ -0,0 +1,89 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Directed acyclic graph of tasks executed on a pool of worker threads.
+///
+/// A task may only depend on tasks that were added before it, so the graph can't
+/// contain cycles. Run() executes every task once its dependencies have finished;
+/// independent tasks run concurrently.
+class TaskGraph
+{
+public:
+    using TaskId = Uint32;
+
+    struct TaskTiming
+    {
+        std::string Name;
+        double      StartMs    = 0; // Relative to the start of Run()
+        double      DurationMs = 0;
+        Uint32      WorkerId   = 0;
+    };
+
+    TaskId AddTask(const char* Name, std::function<void()> Func, std::initializer_list<TaskId> Dependencies = {});
+
+    /// Runs all tasks and blocks until they are complete. The calling thread is used as
+    /// one of the NumThreads workers (0 means std::thread::hardware_concurrency()).
+    /// If a task throws, the remaining tasks that depend on it are not started and the
+    /// exception is rethrown once all running tasks have finished.
+    void Run(Uint32 NumThreads = 0);
+
+    /// Timings of the tasks in the order they were added. Available after Run().
+    const std::vector<TaskTiming>& GetTimings() const { return m_Timings; }
+
+    /// Wall-clock time of the last Run().
+    double GetTotalTimeMs() const { return m_TotalTimeMs; }
+
+    /// Prints the per-task timings to the log.
+    void LogTimings(const char* Title) const;
+
+private:
+    struct Task
+    {
+        std::string           Name;
+        std::function<void()> Func;
+        std::vector<TaskId>   Dependents;
+        Uint32                NumDependencies = 0;
+    };
+
+    std::vector<Task>       m_Tasks;
+    std::vector<TaskTiming> m_Timings;
+    double                  m_TotalTimeMs = 0;
+};
+
+} // namespace Diligent
@@ -0,0 +1,421 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// Device-independent microbenchmarks of the CPU-side frame path.
+//
+// Usage:
+//   Tutorial21_Benchmarks [--baseline <file>] [--update_baseline] [--tolerance <fraction>]
+//
+// Frame path cases are run at instance counts from 34 (the sample scene) up to 1M, light BVH
+// cases at 2 to 100K lights. Every case reports ns/item, heap allocations per iteration and
+// bytes touched per item, where an item is an instance, a light or a light sample.
+// If a baseline file is given, the process returns a non-zero exit code when any case is
+// slower than its baseline by more than the tolerance (25% by default), performs more
+// allocations than recorded, or is in the baseline but was not run.
+// --update_baseline overwrites the file with the current results.
+//
+// Baseline file format: one "<case name> <instance count> <ns/instance> <allocs/iteration>" line per case.
+// Lines starting with '#' are comments. Timings are machine-specific: "-" in place of ns/instance
+// only checks allocations, which is what the checked-in Tutorial21_Benchmarks.baseline does.
+//
+// Build: a separate console executable next to Tutorial21_RayTracing, never compiled into the sample
+// (it defines main()). Sources: Tutorial21_Benchmarks.cpp, AllocationCounter.cpp, SceneBuilder.cpp,
+// LightBVH.cpp, WorkerPool.cpp. Links Diligent-GraphicsTools (CreateGeometryPrimitive) and
+// Diligent-Common; no render device is created.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#endif
+
+#include "AllocationCounter.hpp"
+#include "SceneBuilder.hpp"
+#include "LightBVH.hpp"
+#include "GeometryPrimitives.h"
+#include "DataBlob.h"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+struct BenchmarkResult
+{
+    std::string Name;
+    Uint32      Count            = 0;
+    double      NsPerInstance    = 0;
+    double      AllocsPerIter    = 0;
+    double      BytesPerInstance = 0;
+    double      BaselineNs       = -1; // Negative if the baseline only tracks allocations
+    double      BaselineAllocs   = 0;
+    bool        HasBaseline      = false;
+    bool        Regressed        = false;
+};
+
+// Prevents the compiler from discarding the results of the benchmarked code:
+// the whole object is treated as read by code the compiler can't see.
+template <typename T>
+void DoNotOptimize(const T& Value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    static const volatile void* volatile Sink;
+    Sink = &Value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(Value) : "memory");
+#endif
+}
+
+// Runs Fn in batches until at least MinTime has elapsed and returns the
+// fastest batch time per iteration, which is the most stable metric on a
+// noisy machine.
+template <typename FnType>
+BenchmarkResult RunBenchmark(const char* Name, Uint32 Count, size_t BytesPerIteration, FnType&& Fn)
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr double MinTotalTimeNs = 200e6;
+    constexpr double MinBatchTimeNs = 10e6;
+
+    // Warm-up: fills caches and lets the code allocate any persistent storage.
+    Fn();
+
+    Uint32 BatchSize   = 1;
+    double BestNs      = 1e30;
+    double TotalNs     = 0;
+    size_t TotalAllocs = 0;
+    size_t TotalIters  = 0;
+    while (TotalNs < MinTotalTimeNs)
+    {
+        const Uint64 AllocsBefore = AllocationCounter::GetTotalCount();
+        const auto   Start        = Clock::now();
+        for (Uint32 i = 0; i < BatchSize; ++i)
+            Fn();
+        const double BatchNs = std::chrono::duration<double, std::nano>(Clock::now() - Start).count();
+        TotalAllocs += static_cast<size_t>(AllocationCounter::GetTotalCount() - AllocsBefore);
+        TotalIters += BatchSize;
+        TotalNs += BatchNs;
+
+        BestNs = std::min(BestNs, BatchNs / BatchSize);
+        if (BatchNs < MinBatchTimeNs)
+            BatchSize *= 2;
+    }
+
+    BenchmarkResult Result;
+    Result.Name             = Name;
+    Result.Count            = Count;
+    Result.NsPerInstance    = BestNs / Count;
+    Result.AllocsPerIter    = static_cast<double>(TotalAllocs) / static_cast<double>(TotalIters);
+    Result.BytesPerInstance = static_cast<double>(BytesPerIteration) / Count;
+    return Result;
+}
+
+void BenchmarkInstances(Uint32 NumInstances, std::vector<BenchmarkResult>& Results)
+{
+    const Uint32 NumCubes   = (NumInstances - 2) / 2;
+    const Uint32 NumSpheres = NumInstances - 2 - NumCubes;
+
+    InstanceNameTable CubeNames, SphereNames;
+    CubeNames.Init("Cube Instance", NumCubes);
+    SphereNames.Init("Sphere Instance", NumSpheres);
+
+    // Instance generation as in Tutorial21_RayTracing::UpdateTLAS()
+    {
+        std::vector<TLASBuildInstanceData> Instances(GetSceneInstanceCount(NumCubes, NumSpheres));
+
+        SceneInstanceAttribs Attribs;
+        Attribs.pCubeNames   = &CubeNames;
+        Attribs.pSphereNames = &SphereNames;
+        Attribs.NumTextures  = 4;
+
+        const size_t Bytes = Instances.size() * sizeof(TLASBuildInstanceData);
+        Results.push_back(RunBenchmark("UpdateTLAS.Instances", NumInstances, Bytes, [&]() {
+            Attribs.AnimationTime += 1.f / 60.f;
+            WriteSceneInstances(Attribs, Instances.data());
+            DoNotOptimize(Instances.back().Transform);
+        }));
+    }
+
+    // Hit group name/record generation as in Tutorial21_RayTracing::CreateSBT()
+    {
+        std::vector<HitGroupBinding> Bindings;
+
+        const size_t Bytes = CubeNames.GetStorageSize() + SphereNames.GetStorageSize() * 2 +
+            (NumCubes + NumSpheres * 2 + 2) * sizeof(HitGroupBinding);
+        Results.push_back(RunBenchmark("CreateSBT.Bindings", NumInstances, Bytes, [&]() {
+            WriteHitGroupBindings(CubeNames, SphereNames, Bindings);
+            DoNotOptimize(Bindings.back());
+        }));
+
+        Results.push_back(RunBenchmark("CreateSBT.Names", NumInstances, CubeNames.GetStorageSize() + SphereNames.GetStorageSize(), [&]() {
+            CubeNames.Init("Cube Instance", NumCubes);
+            SphereNames.Init("Sphere Instance", NumSpheres);
+            DoNotOptimize(*SphereNames.GetName(NumSpheres - 1));
+        }));
+    }
+}
+
+// Per-object costs are benchmarked as if every instance required its own
+// constants update and cube attributes.
+void BenchmarkPerObject(Uint32 Count, std::vector<BenchmarkResult>& Results)
+{
+    // HLSL::Constants packing as in Tutorial21_RayTracing::Render()
+    {
+        std::vector<HLSL::Constants> Constants(std::min(Count, 1024u));
+
+        float4x4 ViewProj = float4x4::Translation(1, 2, 3) * float4x4::Projection(PI_F / 4.f, 1.5f, 0.1f, 100.f, false);
+
+        const size_t Bytes = size_t{Count} * (sizeof(float4) + sizeof(float4x4));
+        Results.push_back(RunBenchmark("Render.Constants", Count, Bytes, [&]() {
+            for (Uint32 i = 0; i < Count; ++i)
+            {
+                ViewProj._41 += 1e-6f;
+                UpdateCameraConstants(float3{1, 2, 3}, ViewProj, Constants[i % Constants.size()]);
+            }
+            DoNotOptimize(Constants[0].InvViewProj);
+        }));
+    }
+
+    // HLSL::CubeAttribs construction as in Tutorial21_RayTracing::CreateCubeBLAS()
+    {
+        RefCntAutoPtr<IDataBlob> pCubeVerts, pCubeIndices;
+        GeometryPrimitiveInfo    CubeGeoInfo;
+        CreateGeometryPrimitive(CubeGeometryPrimitiveAttributes{2.f, GEOMETRY_PRIMITIVE_VERTEX_FLAG_ALL},
+                                &pCubeVerts, &pCubeIndices, &CubeGeoInfo);
+        VERIFY_EXPR(CubeGeoInfo.VertexSize == sizeof(CubeVertex));
+
+        const CubeVertex* pVerts   = pCubeVerts->GetConstDataPtr<CubeVertex>();
+        const Uint32*     pIndices = pCubeIndices->GetConstDataPtr<Uint32>();
+
+        HLSL::CubeAttribs Attribs{};
+
+        const size_t Bytes = size_t{Count} * (CubeGeoInfo.NumVertices * sizeof(CubeVertex) + CubeGeoInfo.NumIndices * sizeof(Uint32) + sizeof(Attribs));
+        Results.push_back(RunBenchmark("CreateCubeBLAS.CubeAttribs", Count, Bytes, [&]() {
+            for (Uint32 i = 0; i < Count; ++i)
+                BuildCubeAttribs(pVerts, CubeGeoInfo.NumVertices, pIndices, CubeGeoInfo.NumIndices, Attribs);
+            DoNotOptimize(Attribs.Primitives[0]);
+        }));
+    }
+}
+
+void BenchmarkLightBVH(Uint32 NumLights, std::vector<BenchmarkResult>& Results)
+{
+    // Deterministic pseudo-random lights spread over the scene.
+    std::vector<LightAttribs> Lights(NumLights);
+    Uint32                    Rng  = 12345;
+    auto                      Rand = [&Rng]() {
+        Rng = Rng * 1664525u + 1013904223u;
+        return static_cast<float>(Rng >> 8u) / 16777216.f;
+    };
+    for (LightAttribs& Light : Lights)
+    {
+        Light.Position  = float3{Rand() * 200.f - 100.f, Rand() * 20.f - 6.f, Rand() * 200.f - 100.f};
+        Light.Radius    = Rand() * 0.5f;
+        Light.Color     = float3{Rand(), Rand(), Rand()};
+        Light.Intensity = 1.f + Rand() * 10.f;
+    }
+
+    LightBVH BVH;
+
+    const size_t BuildBytes = Lights.size() * sizeof(LightAttribs) + (NumLights * 2 - 1) * sizeof(LightBVHNode);
+    Results.push_back(RunBenchmark("LightBVH.Build", NumLights, BuildBytes, [&]() {
+        BVH.Build(Lights.data(), NumLights);
+        DoNotOptimize(BVH.GetNodes()[0]);
+    }));
+
+    // Sampling cost grows with the tree depth, so every light count is a separate case.
+    constexpr Uint32  NumSamples = 4096;
+    const std::string SampleName = "LightBVH.Sample." + std::to_string(NumLights);
+    Results.push_back(RunBenchmark(SampleName.c_str(), NumSamples, NumSamples * sizeof(LightBVHNode) * 2, [&]() {
+        Uint32 Sum = 0;
+        for (Uint32 i = 0; i < NumSamples; ++i)
+        {
+            float Pdf = 0;
+            Sum += BVH.SampleLight(float3{0, 0, 0}, (static_cast<float>(i) + 0.5f) / NumSamples, Pdf);
+        }
+        DoNotOptimize(Sum);
+    }));
+}
+
+// Loads the baseline values into Results. Baseline cases that have no matching result
+// are returned in MissingCases.
+bool LoadBaseline(const char* FilePath, std::vector<BenchmarkResult>& Results, std::vector<std::string>& MissingCases)
+{
+    std::ifstream File{FilePath};
+    if (!File)
+    {
+        LOG_ERROR_MESSAGE("Failed to open baseline file '", FilePath, "'");
+        return false;
+    }
+
+    std::string Line;
+    Uint32      LineNumber = 0;
+    while (std::getline(File, Line))
+    {
+        ++LineNumber;
+        if (Line.empty() || Line[0] == '#')
+            continue;
+
+        std::istringstream LineStream{Line};
+
+        std::string Name, NsStr;
+        Uint32      Count  = 0;
+        double      Allocs = 0;
+        if (!(LineStream >> Name >> Count >> NsStr >> Allocs))
+        {
+            LOG_ERROR_MESSAGE("Invalid baseline entry at ", FilePath, "(", LineNumber, "): '", Line, "'");
+            return false;
+        }
+
+        bool Found = false;
+        for (BenchmarkResult& Result : Results)
+        {
+            if (Result.Name == Name && Result.Count == Count)
+            {
+                Result.HasBaseline    = true;
+                Result.BaselineNs     = NsStr == "-" ? -1.0 : std::atof(NsStr.c_str());
+                Result.BaselineAllocs = Allocs;
+                Found                 = true;
+            }
+        }
+        if (!Found)
+            MissingCases.push_back(Name + ' ' + std::to_string(Count));
+    }
+    return true;
+}
+
+bool SaveBaseline(const char* FilePath, const std::vector<BenchmarkResult>& Results)
+{
+    std::ofstream File{FilePath, std::ios::out | std::ios::trunc};
+    if (!File)
+    {
+        LOG_ERROR_MESSAGE("Failed to open baseline file '", FilePath, "' for writing");
+        return false;
+    }
+
+    File << "# <case name> <instance count> <ns/instance> <allocs/iteration>\n";
+    for (const BenchmarkResult& Result : Results)
+        File << Result.Name << ' ' << Result.Count << ' ' << Result.NsPerInstance << ' ' << Result.AllocsPerIter << '\n';
+    return true;
+}
+
+} // namespace
+
+} // namespace Diligent
+
+int main(int argc, char** argv)
+{
+    using namespace Diligent;
+
+    const char* BaselinePath   = nullptr;
+    bool        UpdateBaseline = false;
+    double      Tolerance      = 0.25;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+            BaselinePath = argv[++i];
+        else if (std::strcmp(argv[i], "--update_baseline") == 0)
+            UpdateBaseline = true;
+        else if (std::strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc)
+            Tolerance = std::atof(argv[++i]);
+        else
+        {
+            std::printf("Unknown argument: %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (UpdateBaseline && BaselinePath == nullptr)
+    {
+        std::printf("--update_baseline requires --baseline <file>\n");
+        return EXIT_FAILURE;
+    }
+
+    AllocationCounter::Enable();
+
+    static constexpr Uint32 InstanceCounts[] = {34, 1024, 16384, 262144, 1u << 20u};
+
+    std::vector<BenchmarkResult> Results;
+    for (Uint32 Count : InstanceCounts)
+    {
+        BenchmarkInstances(Count, Results);
+        BenchmarkPerObject(Count, Results);
+    }
+
+    static constexpr Uint32 LightCounts[] = {2, 1000, 10000, 100000};
+    for (Uint32 Count : LightCounts)
+        BenchmarkLightBVH(Count, Results);
+
+    std::vector<std::string> MissingCases;
+    if (BaselinePath != nullptr && !UpdateBaseline)
+    {
+        if (!LoadBaseline(BaselinePath, Results, MissingCases))
+            return EXIT_FAILURE;
+    }
+
+    bool Regressed = false;
+    std::printf("%-28s %10s %12s %12s %14s %12s\n", "Case", "Count", "ns/item", "allocs/iter", "bytes/item", "vs baseline");
+    for (BenchmarkResult& Result : Results)
+    {
+        char BaselineStr[32] = "-";
+        if (Result.HasBaseline)
+        {
+            Result.Regressed = Result.AllocsPerIter > Result.BaselineAllocs + 0.5;
+            if (Result.BaselineNs >= 0)
+            {
+                const double Ratio = Result.NsPerInstance / std::max(Result.BaselineNs, 1e-6);
+                Result.Regressed   = Result.Regressed || Ratio > 1.0 + Tolerance;
+                std::snprintf(BaselineStr, sizeof(BaselineStr), "%+.1f%%%s", (Ratio - 1.0) * 100.0, Result.Regressed ? " FAIL" : "");
+            }
+            else
+            {
+                std::snprintf(BaselineStr, sizeof(BaselineStr), "allocs%s", Result.Regressed ? " FAIL" : " ok");
+            }
+            Regressed = Regressed || Result.Regressed;
+        }
+        std::printf("%-28s %10u %12.3f %12.2f %14.1f %12s\n", Result.Name.c_str(), Result.Count,
+                    Result.NsPerInstance, Result.AllocsPerIter, Result.BytesPerInstance, BaselineStr);
+    }
+
+    for (const std::string& Case : MissingCases)
+    {
+        std::printf("%-39s %12s\n", Case.c_str(), "MISSING");
+        Regressed = true;
+    }
+
+    if (BaselinePath != nullptr && UpdateBaseline)
+        return SaveBaseline(BaselinePath, Results) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    if (Regressed)
+    {
+        std::printf("\nPerformance regression or missing case detected (tolerance %.0f%%)\n", Tolerance * 100.0);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -25,6 +25,18 @@
 #include "ImGuiUtils.hpp"
 #include "AdvancedMath.hpp"
 #include "PlatformMisc.hpp"
+#include "SampleSequences.hpp"
+#include "TaskGraph.hpp"
+#include "AllocationCounter.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <utility>
 
 namespace Diligent
 {
@@ -35,6 +47,92 @@ SampleBase* CreateSample()
 }
 
 
+auto Tutorial21_RayTracing::ProcessCommandLine(int argc, const char* const* argv) -> CommandLineStatus
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* Arg     = argv[i];
+        const char* NextArg = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(Arg, "--capture") == 0 && NextArg != nullptr)
+        {
+            m_CaptureFilePath = NextArg;
+            ++i;
+        }
+        else if (std::strcmp(Arg, "--replay") == 0 && NextArg != nullptr)
+        {
+            m_ReplayFilePath = NextArg;
+            ++i;
+        }
+        else if (std::strcmp(Arg, "--exit_after_replay") == 0)
+        {
+            m_ExitAfterReplay = true;
+        }
+        else if (std::strcmp(Arg, "--replay_timings") == 0 && NextArg != nullptr)
+        {
+            m_ReplayTimingsFilePath = NextArg;
+            ++i;
+        }
+        else if (std::strcmp(Arg, "--dump_frames") == 0 && NextArg != nullptr)
+        {
+            m_DumpFramesPrefix = NextArg;
+            ++i;
+        }
+        else if (std::strcmp(Arg, "--dump_format") == 0 && NextArg != nullptr)
+        {
+            if (std::strcmp(NextArg, "png") == 0)
+                m_DumpFramesFormat = FRAME_ENCODE_FORMAT_PNG;
+            else if (std::strcmp(NextArg, "exr") == 0)
+                m_DumpFramesFormat = FRAME_ENCODE_FORMAT_EXR;
+            else if (std::strcmp(NextArg, "raw") == 0)
+                m_DumpFramesFormat = FRAME_ENCODE_FORMAT_RAW;
+            else
+            {
+                LOG_ERROR_MESSAGE("Unknown frame dump format '", NextArg, "'. Supported formats: png, exr, raw");
+                return CommandLineStatus::Error;
+            }
+            ++i;
+        }
+        else if (std::strcmp(Arg, "--check_allocations") == 0)
+        {
+            m_CheckAllocations = true;
+            AllocationCounter::Enable();
+        }
+        else if (std::strcmp(Arg, "--multi_view") == 0 && NextArg != nullptr)
+        {
+            if (std::strcmp(NextArg, "cubemap") == 0)
+                m_MultiViewMode = MULTI_VIEW_MODE_CUBEMAP;
+            else if (std::strcmp(NextArg, "stereo") == 0)
+                m_MultiViewMode = MULTI_VIEW_MODE_STEREO;
+            else
+            {
+                LOG_ERROR_MESSAGE("Unknown multi-view mode '", NextArg, "'. Supported modes: cubemap, stereo");
+                return CommandLineStatus::Error;
+            }
+            ++i;
+        }
+        else if (std::strcmp(Arg, "--multi_view_size") == 0 && NextArg != nullptr)
+        {
+            m_MultiViewSize = static_cast<Uint32>(std::max(std::atoi(NextArg), 1));
+            ++i;
+        }
+        else if (std::strcmp(Arg, "--num_lights") == 0 && NextArg != nullptr)
+        {
+            // Lights beyond the two scene lights are generated at fixed pseudo-random positions.
+            m_NumLights = std::min(std::max(std::atoi(NextArg), 2), static_cast<int>(MaxLights));
+            ++i;
+        }
+    }
+
+    if (!m_CaptureFilePath.empty() && !m_ReplayFilePath.empty())
+    {
+        LOG_ERROR_MESSAGE("--capture and --replay can't be used at the same time");
+        return CommandLineStatus::Error;
+    }
+
+    return CommandLineStatus::OK;
+}
+
 void Tutorial21_RayTracing::CreateGraphicsPSO()
 {
     GraphicsPipelineStateCreateInfo PSOCreateInfo;
@@ -95,6 +193,8 @@ void Tutorial21_RayTracing::CreateRayTracingPSO()
 
     ShaderMacroHelper Macros;
     Macros.AddShaderMacro("NUM_TEXTURES", NumTextures);
+    // Ray generation reads the camera from g_Views[DispatchRaysIndex().z] and writes to g_MultiViewColorBuffer.
+    Macros.AddShaderMacro("MULTI_VIEW", m_MultiViewMode != MULTI_VIEW_MODE_NONE);
 
     ShaderCreateInfo ShaderCI;
     ShaderCI.Desc.UseCombinedTextureSamplers = false;
@@ -198,7 +298,14 @@ void Tutorial21_RayTracing::CreateRayTracingPSO()
     ResourceLayout
         .AddVariable(SHADER_TYPE_RAY_GEN | SHADER_TYPE_RAY_MISS | SHADER_TYPE_RAY_CLOSEST_HIT,
                      "g_ConstantsCB", SHADER_RESOURCE_VARIABLE_TYPE_STATIC)
-        .AddVariable(SHADER_TYPE_RAY_GEN, "g_ColorBuffer", SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC);
+        .AddVariable(SHADER_TYPE_RAY_GEN, "g_ColorBuffer", SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC)
+        // Temporal reuse buffers are swapped every frame.
+        .AddVariable(SHADER_TYPE_RAY_GEN, "g_MotionVectors", SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC)
+        .AddVariable(SHADER_TYPE_RAY_GEN, "g_HistoryColor", SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC)
+        .AddVariable(SHADER_TYPE_RAY_GEN, "g_PrevHistoryColor", SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC)
+        .AddVariable(SHADER_TYPE_RAY_GEN, "g_Surface", SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC)
+        .AddVariable(SHADER_TYPE_RAY_GEN, "g_PrevSurface", SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC)
+        .AddVariable(SHADER_TYPE_RAY_GEN, "g_MultiViewColorBuffer", SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC);
 
     PSOCreateInfo.PSODesc.ResourceLayout = ResourceLayout;
 
@@ -211,31 +318,292 @@ void Tutorial21_RayTracing::CreateRayTracingPSO()
 
     m_pRayTracingPSO->CreateShaderResourceBinding(&m_pRayTracingSRB, true);
     VERIFY_EXPR(m_pRayTracingSRB != nullptr);
+
+    if (m_MultiViewMode != MULTI_VIEW_MODE_NONE &&
+        (m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_GEN, "g_Views") == nullptr ||
+         m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_GEN, "g_MultiViewColorBuffer") == nullptr))
+    {
+        // Without these resources every view would be traced with the main camera into an unbound buffer.
+        LOG_ERROR_MESSAGE("The ray generation shader does not implement the MULTI_VIEW path (g_Views and g_MultiViewColorBuffer "
+                          "are not declared). Falling back to single-view rendering.");
+        m_MultiViewMode = MULTI_VIEW_MODE_NONE;
+        m_pRayTracingSRB.Release();
+        m_pRayTracingPSO.Release();
+        CreateRayTracingPSO();
+        return;
+    }
+
+    // Temporal reuse buffers are only created if the ray generation shader uses them.
+    m_TemporalReuseSupported = m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_GEN, "g_MotionVectors") != nullptr;
 }
 
 void Tutorial21_RayTracing::LoadTextures()
 {
-    IDeviceObject*          pTexSRVs[NumTextures] = {};
-    RefCntAutoPtr<ITexture> pTex[NumTextures];
-    StateTransitionDesc     Barriers[NumTextures];
     for (int tex = 0; tex < NumTextures; ++tex)
     {
         TextureLoadInfo loadInfo;
         loadInfo.IsSRGB = true;
         std::stringstream ss;
         ss << "DGLogo" << tex << ".png";
-        CreateTextureFromFile(ss.str().c_str(), loadInfo, m_pDevice, &pTex[tex]);
-        ITextureView* srv = pTex[tex]->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
-        pTexSRVs[tex]     = srv;
-        Barriers[tex]     = StateTransitionDesc{pTex[tex], RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, STATE_TRANSITION_FLAG_UPDATE_STATE};
+        CreateTextureFromFile(ss.str().c_str(), loadInfo, m_pDevice, &m_pCubeTextures[tex]);
+        VERIFY_EXPR(m_pCubeTextures[tex] != nullptr);
+    }
+
+    CreateTextureFromFile("Ground.jpg", TextureLoadInfo{}, m_pDevice, &m_pGroundTex);
+    VERIFY_EXPR(m_pGroundTex != nullptr);
+}
+
+void Tutorial21_RayTracing::BindResources()
+{
+    IDeviceObject*      pTexSRVs[NumTextures] = {};
+    StateTransitionDesc Barriers[NumTextures];
+    for (int tex = 0; tex < NumTextures; ++tex)
+    {
+        pTexSRVs[tex] = m_pCubeTextures[tex]->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+        Barriers[tex] = StateTransitionDesc{m_pCubeTextures[tex], RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, STATE_TRANSITION_FLAG_UPDATE_STATE};
     }
     m_pImmediateContext->TransitionResourceStates(_countof(Barriers), Barriers);
     m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_CLOSEST_HIT, "g_CubeTextures")->SetArray(pTexSRVs, 0, NumTextures);
 
-    RefCntAutoPtr<ITexture> pGroundTex;
-    CreateTextureFromFile("Ground.jpg", TextureLoadInfo{}, m_pDevice, &pGroundTex);
     m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_CLOSEST_HIT, "g_GroundTexture")
-        ->Set(pGroundTex->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE));
+        ->Set(m_pGroundTex->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE));
+
+    m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_CLOSEST_HIT, "g_CubeAttribsCB")
+        ->Set(m_CubeAttribsCB);
+
+    m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_INTERSECTION, "g_BoxAttribs")
+        ->Set(m_BoxAttribsCB->GetDefaultView(BUFFER_VIEW_SHADER_RESOURCE));
+
+    // Shaders that use per-pixel scrambling read the rank of their pixel modulo the texture size.
+    for (SHADER_TYPE ShaderType : {SHADER_TYPE_RAY_GEN, SHADER_TYPE_RAY_CLOSEST_HIT})
+    {
+        if (IShaderResourceVariable* pVar = m_pRayTracingSRB->GetVariableByName(ShaderType, "g_BlueNoise"))
+            pVar->Set(m_pBlueNoiseTex->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE));
+    }
+
+    // Shaders that reuse shading results of the previous frame declare the temporal constants.
+    for (SHADER_TYPE ShaderType : {SHADER_TYPE_RAY_GEN, SHADER_TYPE_RAY_CLOSEST_HIT})
+    {
+        if (IShaderResourceVariable* pVar = m_pRayTracingSRB->GetVariableByName(ShaderType, "g_TemporalCB"))
+            pVar->Set(m_TemporalCB);
+    }
+}
+
+void Tutorial21_RayTracing::CreateBlueNoiseTexture()
+{
+    static constexpr Uint32 BlueNoiseSize = 64;
+
+    std::vector<Uint16> Ranks;
+    SampleSequence::GenerateBlueNoise(BlueNoiseSize, Ranks);
+
+    // Normalize ranks to the full 16-bit range so that the shaders read uniformly distributed values in [0, 1].
+    for (Uint16& Rank : Ranks)
+        Rank = static_cast<Uint16>((Uint32{Rank} * 65535u) / (BlueNoiseSize * BlueNoiseSize - 1));
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "Blue noise texture";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Width     = BlueNoiseSize;
+    TexDesc.Height    = BlueNoiseSize;
+    TexDesc.Format    = TEX_FORMAT_R16_UNORM;
+    TexDesc.Usage     = USAGE_IMMUTABLE;
+    TexDesc.BindFlags = BIND_SHADER_RESOURCE;
+
+    TextureSubResData Level0{Ranks.data(), BlueNoiseSize * sizeof(Uint16)};
+    TextureData       InitData{&Level0, 1};
+    m_pDevice->CreateTexture(TexDesc, &InitData, &m_pBlueNoiseTex);
+    VERIFY_EXPR(m_pBlueNoiseTex != nullptr);
+}
+
+void Tutorial21_RayTracing::UpdateDiscPoints()
+{
+    // Shadow PCF and reflection blur use the first N points. The first 16 points of the
+    // Sobol sequence form a (0,4,2)-net, so every power-of-two prefix is stratified.
+    // The digital shift by 0.5 keeps the net property and moves the first point to the disc center.
+    // When the pattern is animated, every frame uses a different Owen scrambling of the net.
+    static constexpr float DiscRadius = 4.0f;
+
+    const Uint32 Seed = m_AnimateSamplePattern ? SampleSequence::HashSeed(0, 0, static_cast<Uint32>(m_FrameIndex)) : 0;
+    if (m_DiscPointsValid && Seed == m_DiscPointsSeed)
+        return;
+    m_DiscPointsValid = true;
+    m_DiscPointsSeed  = Seed;
+
+    constexpr Uint32 NumPoints = static_cast<Uint32>(std::size(m_Constants.DiscPoints) * 2);
+    for (Uint32 i = 0; i < NumPoints; ++i)
+    {
+        Uint32 x = SampleSequence::Sobol(i, 0) ^ 0x80000000u;
+        Uint32 y = SampleSequence::Sobol(i, 1) ^ 0x80000000u;
+        if (Seed != 0)
+        {
+            x = SampleSequence::OwenScramble(x, Seed);
+            y = SampleSequence::OwenScramble(y, Seed ^ 0x9E3779B9u);
+        }
+
+        const float2 p = SampleSequence::SquareToConcentricDisc(float2{SampleSequence::ToUnitFloat(x), SampleSequence::ToUnitFloat(y)}) * DiscRadius;
+
+        float4& Dst = m_Constants.DiscPoints[i / 2];
+        if (i % 2 == 0)
+        {
+            Dst.x = p.x;
+            Dst.y = p.y;
+        }
+        else
+        {
+            Dst.z = p.x;
+            Dst.w = p.y;
+        }
+    }
+}
+
+void Tutorial21_RayTracing::UpdateTemporalReuse(const float3& CameraPos, const float4x4& ViewProj)
+{
+    TemporalConstants& Temporal = m_TemporalConstants;
+
+    Temporal.PrevViewProj  = m_HasHistory ? m_PrevViewProj : ViewProj;
+    Temporal.PrevCameraPos = float4{m_HasHistory ? m_PrevCameraPos : CameraPos, 1};
+    Temporal.FrameIndex    = static_cast<Uint32>(m_FrameIndex);
+    Temporal.HistoryValid  = m_TemporalReuseSupported && m_EnableTemporalReuse && m_HasHistory && m_MultiViewMode == MULTI_VIEW_MODE_NONE ? 1 : 0;
+    m_pImmediateContext->UpdateBuffer(m_TemporalCB, 0, sizeof(Temporal), &Temporal, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    // Hit shaders may still read the constants, but there are no buffers to bind.
+    if (!m_TemporalReuseSupported)
+        return;
+
+    // The frame writes to the current buffers and reads the previous frame from the other ones.
+    const Uint32 Curr = static_cast<Uint32>(m_FrameIndex & 1u);
+    const Uint32 Prev = Curr ^ 1u;
+
+    const std::pair<const char*, ITextureView*> Views[] = {
+        {"g_MotionVectors", m_pMotionVectorsRT->GetDefaultView(TEXTURE_VIEW_UNORDERED_ACCESS)},
+        {"g_HistoryColor", m_pHistoryRT[Curr]->GetDefaultView(TEXTURE_VIEW_UNORDERED_ACCESS)},
+        {"g_PrevHistoryColor", m_pHistoryRT[Prev]->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE)},
+        {"g_Surface", m_pSurfaceRT[Curr]->GetDefaultView(TEXTURE_VIEW_UNORDERED_ACCESS)},
+        {"g_PrevSurface", m_pSurfaceRT[Prev]->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE)},
+    };
+    for (const auto& View : Views)
+    {
+        if (IShaderResourceVariable* pVar = m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_GEN, View.first))
+            pVar->Set(View.second);
+    }
+
+    m_PrevViewProj  = ViewProj;
+    m_PrevCameraPos = CameraPos;
+    m_HasHistory    = true;
+}
+
+void Tutorial21_RayTracing::UpdateMultiViews(const float3& CameraPos, const float4x4& CameraView)
+{
+    static_assert(CUBEMAP_FACE_COUNT <= MaxMultiViews, "Not enough views for a cubemap");
+
+    switch (m_MultiViewMode)
+    {
+        case MULTI_VIEW_MODE_CUBEMAP:
+            GetCubemapViews(CameraPos, m_Constants.ClipPlanes.x, m_Constants.ClipPlanes.y,
+                            m_pDevice->GetDeviceInfo().NDC.MinZ == -1, m_MultiViews);
+            m_NumMultiViews = CUBEMAP_FACE_COUNT;
+            break;
+
+        case MULTI_VIEW_MODE_STEREO:
+            GetStereoViews(CameraView, m_Camera.GetProjMatrix(), m_EyeSeparation, m_MultiViews);
+            m_NumMultiViews = 2;
+            break;
+
+        default:
+            m_NumMultiViews = 0;
+    }
+}
+
+void Tutorial21_RayTracing::TraceRays(const TraceRaysAttribs& Attribs)
+{
+    if (m_pTraceDurationQuery)
+        m_pTraceDurationQuery->Begin(m_pImmediateContext);
+
+    m_pImmediateContext->TraceRays(Attribs);
+
+    // Query results arrive with a few frames of latency, but in the same order
+    // as they were issued.
+    double TraceDuration = 0;
+    if (m_pTraceDurationQuery && m_pTraceDurationQuery->End(m_pImmediateContext, TraceDuration))
+    {
+        if (m_NumResolvedGPUTimings < m_ReplayTimings.size())
+            m_ReplayTimings[m_NumResolvedGPUTimings++].GPUTraceTimeMs = TraceDuration * 1000.0;
+    }
+}
+
+void Tutorial21_RayTracing::TraceMultiView(const MultiViewCamera* pViews, Uint32 NumViews, Uint32 Width, Uint32 Height)
+{
+    VERIFY(NumViews > 0 && NumViews <= MaxMultiViews, "Invalid number of views");
+
+    if (!m_MultiViewBuffer)
+    {
+        // The buffer is created with a fixed capacity so that it is bound to the SRB only once.
+        BufferDesc BuffDesc;
+        BuffDesc.Name              = "Multi-view buffer";
+        BuffDesc.Usage             = USAGE_DEFAULT;
+        BuffDesc.BindFlags         = BIND_SHADER_RESOURCE;
+        BuffDesc.Mode              = BUFFER_MODE_STRUCTURED;
+        BuffDesc.ElementByteStride = sizeof(MultiViewAttribs);
+        BuffDesc.Size              = sizeof(MultiViewAttribs) * MaxMultiViews;
+        m_pDevice->CreateBuffer(BuffDesc, nullptr, &m_MultiViewBuffer);
+        VERIFY_EXPR(m_MultiViewBuffer);
+
+        m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_GEN, "g_Views")->Set(m_MultiViewBuffer->GetDefaultView(BUFFER_VIEW_SHADER_RESOURCE));
+    }
+
+    if (m_pMultiViewRT == nullptr ||
+        m_pMultiViewRT->GetDesc().Width != Width ||
+        m_pMultiViewRT->GetDesc().Height != Height ||
+        m_pMultiViewRT->GetDesc().ArraySize != NumViews)
+    {
+        // Cubemap views follow the D3D face layout, so the slices can be used as a cubemap as is.
+        TextureDesc RTDesc       = {};
+        RTDesc.Name              = "Multi-view color buffer";
+        RTDesc.Type              = RESOURCE_DIM_TEX_2D_ARRAY;
+        RTDesc.Width             = Width;
+        RTDesc.Height            = Height;
+        RTDesc.ArraySize         = NumViews;
+        RTDesc.BindFlags         = BIND_UNORDERED_ACCESS | BIND_SHADER_RESOURCE;
+        RTDesc.ClearValue.Format = m_ColorBufferFormat;
+        RTDesc.Format            = m_ColorBufferFormat;
+        m_pMultiViewRT.Release();
+        m_pDevice->CreateTexture(RTDesc, nullptr, &m_pMultiViewRT);
+        VERIFY_EXPR(m_pMultiViewRT != nullptr);
+
+        RTDesc.Name      = "Multi-view preview";
+        RTDesc.Type      = RESOURCE_DIM_TEX_2D;
+        RTDesc.ArraySize = 1;
+        RTDesc.BindFlags = BIND_SHADER_RESOURCE;
+        m_pMultiViewPreviewRT.Release();
+        m_pDevice->CreateTexture(RTDesc, nullptr, &m_pMultiViewPreviewRT);
+        VERIFY_EXPR(m_pMultiViewPreviewRT != nullptr);
+    }
+
+    WriteMultiViewAttribs(pViews, NumViews, m_MultiViewAttribs);
+    m_pImmediateContext->UpdateBuffer(m_MultiViewBuffer, 0, sizeof(MultiViewAttribs) * NumViews, m_MultiViewAttribs,
+                                      RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_GEN, "g_MultiViewColorBuffer")->Set(m_pMultiViewRT->GetDefaultView(TEXTURE_VIEW_UNORDERED_ACCESS));
+    // The shader may still declare the single-view output, which must not be left unbound.
+    if (IShaderResourceVariable* pVar = m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_GEN, "g_ColorBuffer"))
+        pVar->Set(m_pColorRT->GetDefaultView(TEXTURE_VIEW_UNORDERED_ACCESS));
+
+    m_pImmediateContext->SetPipelineState(m_pRayTracingPSO);
+    m_pImmediateContext->CommitShaderResources(m_pRayTracingSRB, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    // All views share the TLAS and the SBT, and are traced in one dispatch.
+    TraceRaysAttribs Attribs;
+    Attribs.DimensionX = Width;
+    Attribs.DimensionY = Height;
+    Attribs.DimensionZ = NumViews;
+    Attribs.pSBT       = m_pSBT;
+    TraceRays(Attribs);
+
+    // Copy the previewed view to a 2D texture that can be blitted to the swap chain and dumped.
+    CopyTextureAttribs CopyAttribs{m_pMultiViewRT, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                                   m_pMultiViewPreviewRT, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+    CopyAttribs.SrcSlice = std::min(static_cast<Uint32>(m_MultiViewPreview), NumViews - 1);
+    m_pImmediateContext->CopyTexture(CopyAttribs);
 }
 
 void Tutorial21_RayTracing::CreateCubeBLAS()
@@ -246,28 +614,13 @@ void Tutorial21_RayTracing::CreateCubeBLAS()
     CreateGeometryPrimitive(CubeGeometryPrimitiveAttributes{CubeSize, GEOMETRY_PRIMITIVE_VERTEX_FLAG_ALL},
                             &pCubeVerts, &pCubeIndices, &CubeGeoInfo);
 
-    struct CubeVertex
-    {
-        float3 Pos;
-        float3 Normal;
-        float2 UV;
-    };
     VERIFY_EXPR(CubeGeoInfo.VertexSize == sizeof(CubeVertex));
     const CubeVertex* pVerts   = pCubeVerts->GetConstDataPtr<CubeVertex>();
     const Uint32*     pIndices = pCubeIndices->GetConstDataPtr<Uint32>();
 
     {
         HLSL::CubeAttribs Attribs{};
-        for (Uint32 v = 0; v < CubeGeoInfo.NumVertices; ++v)
-        {
-            Attribs.UVs[v]     = {pVerts[v].UV, 0, 0};
-            Attribs.Normals[v] = pVerts[v].Normal;
-        }
-        for (Uint32 i = 0; i < CubeGeoInfo.NumIndices; i += 3)
-        {
-            const Uint32* tri         = &pIndices[i];
-            Attribs.Primitives[i / 3] = uint4{tri[0], tri[1], tri[2], 0};
-        }
+        BuildCubeAttribs(pVerts, CubeGeoInfo.NumVertices, pIndices, CubeGeoInfo.NumIndices, Attribs);
         BufferDesc BuffDesc;
         BuffDesc.Name      = "Cube Attribs";
         BuffDesc.Usage     = USAGE_IMMUTABLE;
@@ -276,8 +629,6 @@ void Tutorial21_RayTracing::CreateCubeBLAS()
         BufferData BufData = {&Attribs, BuffDesc.Size};
         m_pDevice->CreateBuffer(BuffDesc, &BufData, &m_CubeAttribsCB);
         VERIFY_EXPR(m_CubeAttribsCB);
-        m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_CLOSEST_HIT, "g_CubeAttribsCB")
-            ->Set(m_CubeAttribsCB);
     }
 
     RefCntAutoPtr<IBuffer>             pCubeVertexBuffer, pCubeIndexBuffer;
@@ -332,6 +683,8 @@ void Tutorial21_RayTracing::CreateCubeBLAS()
         Attribs.BLASTransitionMode          = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
         Attribs.GeometryTransitionMode      = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
         Attribs.ScratchBufferTransitionMode = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+
+        std::lock_guard<std::mutex> Lock{m_InitContextMtx};
         m_pImmediateContext->BuildBLAS(Attribs);
     }
 }
@@ -351,8 +704,6 @@ void Tutorial21_RayTracing::CreateProceduralBLAS()
     BufferData BoxData        = {Boxes, sizeof(Boxes)};
     m_pDevice->CreateBuffer(BoxDesc, &BoxData, &m_BoxAttribsCB);
     VERIFY_EXPR(m_BoxAttribsCB);
-    m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_INTERSECTION, "g_BoxAttribs")
-        ->Set(m_BoxAttribsCB->GetDefaultView(BUFFER_VIEW_SHADER_RESOURCE));
 
     BLASBoundingBoxDesc BoxInfo;
     BoxInfo.GeometryName = "Box";
@@ -387,14 +738,15 @@ void Tutorial21_RayTracing::CreateProceduralBLAS()
     Attribs.BLASTransitionMode          = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
     Attribs.GeometryTransitionMode      = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
     Attribs.ScratchBufferTransitionMode = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+
+    std::lock_guard<std::mutex> Lock{m_InitContextMtx};
     m_pImmediateContext->BuildBLAS(Attribs);
 }
 
 void Tutorial21_RayTracing::UpdateTLAS()
 {
-    static constexpr int NumLocalCubes   = 16;
-    static constexpr int NumLocalSpheres = 16;
-    static constexpr int NumInstances    = NumLocalCubes + NumLocalSpheres + 2; // ground + glass
+    static constexpr Uint32 NumInstances = NumCubes + NumSpheres + 2; // ground + glass
+    VERIFY_EXPR(GetSceneInstanceCount(m_CubeInstanceNames.GetCount(), m_SphereInstanceNames.GetCount()) == NumInstances);
 
     bool NeedUpdate = true;
 
@@ -435,60 +787,14 @@ void Tutorial21_RayTracing::UpdateTLAS()
 
     TLASBuildInstanceData Instances[NumInstances];
 
-    // Cubes around circle
-    for (int i = 0; i < NumLocalCubes; ++i)
-    {
-        auto& inst        = Instances[i];
-       // inst.InstanceName = "Cube Instance " + std::to_string(i + 1);
-        inst.CustomId     = i % NumTextures;
-        inst.pBLAS        = m_pCubeBLAS;
-        inst.Mask         = OPAQUE_GEOM_MASK;
-        float angle       = 2 * PI_F * i / NumLocalCubes;
-        float radius      = 5.0f;
-        float x           = std::cos(angle) * radius;
-        float y           = std::sin(m_AnimationTime + i) * 1.0f;
-        float z           = std::sin(angle) * radius;
-        inst.Transform.SetTranslation(x, y, z);
-        inst.Transform.SetRotation(float3x3::RotationY(angle + m_AnimationTime).Data());
-    }
-
-    // Spheres around larger circle
-    for (int i = 0; i < NumLocalSpheres; ++i)
-    {
-        auto& inst        = Instances[NumLocalCubes + i];
-       // inst.InstanceName = "Sphere Instance " + std::to_string(i + 1);
-        inst.CustomId     = 0;
-        inst.pBLAS        = m_pProceduralBLAS;
-        inst.Mask         = OPAQUE_GEOM_MASK;
-        float angle       = 2 * PI_F * i / NumLocalSpheres;
-        float radius      = 7.0f;
-        float x           = std::cos(angle) * radius;
-        float z           = std::sin(angle) * radius;
-        inst.Transform.SetTranslation(x, -2.0f, z);
-    }
-
-    // Ground
-    {
-        auto& g        = Instances[NumLocalCubes + NumLocalSpheres];
-        g.InstanceName = "Ground Instance";
-        g.pBLAS        = m_pCubeBLAS;
-        g.Mask         = OPAQUE_GEOM_MASK;
-        g.Transform.SetRotation(float3x3::Scale(100.0f, 0.1f, 100.0f).Data());
-        g.Transform.SetTranslation(0.0f, -6.0f, 0.0f);
-    }
-
-    // Glass cube
-    {
-        auto& gl        = Instances[NumLocalCubes + NumLocalSpheres + 1];
-        gl.InstanceName = "Glass Instance";
-        gl.pBLAS        = m_pCubeBLAS;
-        gl.Mask         = TRANSPARENT_GEOM_MASK;
-        gl.Transform.SetRotation(
-            (float3x3::Scale(1.5f, 1.5f, 1.5f) *
-             float3x3::RotationY(m_AnimationTime * PI_F * 0.25f))
-                .Data());
-        gl.Transform.SetTranslation(3.0f, -4.0f, -5.0f);
-    }
+    SceneInstanceAttribs SceneAttribs;
+    SceneAttribs.pCubeBLAS       = m_pCubeBLAS;
+    SceneAttribs.pProceduralBLAS = m_pProceduralBLAS;
+    SceneAttribs.pCubeNames      = &m_CubeInstanceNames;
+    SceneAttribs.pSphereNames    = &m_SphereInstanceNames;
+    SceneAttribs.NumTextures     = NumTextures;
+    SceneAttribs.AnimationTime   = m_AnimationTime;
+    WriteSceneInstances(SceneAttribs, Instances);
 
     BuildTLASAttribs Attribs;
     Attribs.pTLAS                        = m_pTLAS;
@@ -506,11 +812,105 @@ void Tutorial21_RayTracing::UpdateTLAS()
     m_pImmediateContext->BuildTLAS(Attribs);
 }
 
-void Tutorial21_RayTracing::CreateSBT()
+void Tutorial21_RayTracing::SetExtraLights(const LightAttribs* pLights, Uint32 NumLights)
+{
+    const Uint32 NumSceneLights = static_cast<Uint32>(std::size(m_Constants.LightPos));
+    if (NumLights > MaxLights - NumSceneLights)
+    {
+        LOG_WARNING_MESSAGE("Only ", MaxLights - NumSceneLights, " of ", NumLights, " extra lights will be used");
+        NumLights = MaxLights - NumSceneLights;
+    }
+
+    // Scene lights are filled in by UpdateLights().
+    m_Lights.resize(NumSceneLights + NumLights);
+    std::copy(pLights, pLights + NumLights, m_Lights.begin() + NumSceneLights);
+    m_LightsDirty = true;
+}
+
+void Tutorial21_RayTracing::GenerateExtraLights(Uint32 NumLights)
 {
-    static constexpr int NumLocalCubes   = 16;
-    static constexpr int NumLocalSpheres = 16;
+    // Small colored lights scattered over the scene. Positions only depend on the light index,
+    // so the same count always produces the same lights.
+    std::vector<LightAttribs> Lights(NumLights);
+    for (Uint32 i = 0; i < NumLights; ++i)
+    {
+        auto Rand = [i](Uint32 Dim) { return SampleSequence::ToUnitFloat(SampleSequence::HashSeed(i, Dim, 0)); };
+
+        LightAttribs& Light = Lights[i];
+        Light.Position      = float3{Rand(0) * 24.f - 12.f, Rand(1) * 12.f - 4.f, Rand(2) * 24.f - 12.f};
+        Light.Radius        = 0.1f;
+        Light.Color         = float3{0.2f + 0.8f * Rand(3), 0.2f + 0.8f * Rand(4), 0.2f + 0.8f * Rand(5)};
+        Light.Intensity     = 0.5f;
+    }
+    SetExtraLights(Lights.data(), NumLights);
+}
 
+void Tutorial21_RayTracing::UpdateLights()
+{
+    if (!m_LightsBuffer)
+    {
+        // Buffers are created with a fixed capacity so that they are bound to the SRB only once.
+        BufferDesc BuffDesc;
+        BuffDesc.Name              = "Lights buffer";
+        BuffDesc.Usage             = USAGE_DEFAULT;
+        BuffDesc.BindFlags         = BIND_SHADER_RESOURCE;
+        BuffDesc.Mode              = BUFFER_MODE_STRUCTURED;
+        BuffDesc.ElementByteStride = sizeof(LightAttribs);
+        BuffDesc.Size              = sizeof(LightAttribs) * MaxLights;
+        m_pDevice->CreateBuffer(BuffDesc, nullptr, &m_LightsBuffer);
+        VERIFY_EXPR(m_LightsBuffer);
+
+        BuffDesc.Name              = "Light BVH buffer";
+        BuffDesc.ElementByteStride = sizeof(LightBVHNode);
+        BuffDesc.Size              = sizeof(LightBVHNode) * (MaxLights * 2 - 1);
+        m_pDevice->CreateBuffer(BuffDesc, nullptr, &m_LightBVHBuffer);
+        VERIFY_EXPR(m_LightBVHBuffer);
+
+        // Hit shaders that select lights through the BVH instead of looping over LightPos[] declare these buffers.
+        if (IShaderResourceVariable* pVar = m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_CLOSEST_HIT, "g_Lights"))
+            pVar->Set(m_LightsBuffer->GetDefaultView(BUFFER_VIEW_SHADER_RESOURCE));
+        if (IShaderResourceVariable* pVar = m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_CLOSEST_HIT, "g_LightBVH"))
+            pVar->Set(m_LightBVHBuffer->GetDefaultView(BUFFER_VIEW_SHADER_RESOURCE));
+    }
+
+    const size_t NumSceneLights = std::size(m_Constants.LightPos);
+    if (m_Lights.size() < NumSceneLights)
+    {
+        m_Lights.resize(NumSceneLights);
+        m_LightsDirty = true;
+    }
+
+    for (size_t i = 0; i < NumSceneLights; ++i)
+    {
+        LightAttribs Light;
+        Light.Position  = float3::MakeVector(m_Constants.LightPos[i].Data());
+        Light.Radius    = 0;
+        Light.Color     = float3::MakeVector(m_Constants.LightColor[i].Data());
+        Light.Intensity = 1;
+        if (std::memcmp(&Light, &m_Lights[i], sizeof(Light)) != 0)
+        {
+            m_Lights[i]   = Light;
+            m_LightsDirty = true;
+        }
+    }
+    VERIFY(m_Lights.size() <= MaxLights, "Too many lights");
+
+    // The tree and the buffers only need to be updated when a light has changed.
+    if (!m_LightsDirty)
+        return;
+    m_LightsDirty = false;
+
+    m_LightBVH.Build(m_Lights.data(), static_cast<Uint32>(m_Lights.size()));
+
+    const std::vector<LightBVHNode>& Nodes = m_LightBVH.GetNodes();
+    m_pImmediateContext->UpdateBuffer(m_LightsBuffer, 0, static_cast<Uint64>(sizeof(LightAttribs) * m_Lights.size()),
+                                      m_Lights.data(), RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    m_pImmediateContext->UpdateBuffer(m_LightBVHBuffer, 0, static_cast<Uint64>(sizeof(LightBVHNode) * Nodes.size()),
+                                      Nodes.data(), RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+}
+
+void Tutorial21_RayTracing::CreateSBT()
+{
     ShaderBindingTableDesc SBTDesc;
     SBTDesc.Name = "SBT";
     SBTDesc.pPSO = m_pRayTracingPSO;
@@ -521,25 +921,13 @@ void Tutorial21_RayTracing::CreateSBT()
     m_pSBT->BindMissShader("PrimaryMiss", PRIMARY_RAY_INDEX);
     m_pSBT->BindMissShader("ShadowMiss", SHADOW_RAY_INDEX);
 
-    for (int i = 0; i < NumLocalCubes; ++i)
-        m_pSBT->BindHitGroupForInstance(m_pTLAS,
-                                        ("Cube Instance " + std::to_string(i + 1)).c_str(),
-                                        PRIMARY_RAY_INDEX, "CubePrimaryHit");
-
-    for (int i = 0; i < NumLocalSpheres; ++i)
-        m_pSBT->BindHitGroupForInstance(m_pTLAS,
-                                        ("Sphere Instance " + std::to_string(i + 1)).c_str(),
-                                        PRIMARY_RAY_INDEX, "SpherePrimaryHit");
-
-    m_pSBT->BindHitGroupForInstance(m_pTLAS, "Ground Instance", PRIMARY_RAY_INDEX, "GroundHit");
-    m_pSBT->BindHitGroupForInstance(m_pTLAS, "Glass Instance", PRIMARY_RAY_INDEX, "GlassPrimaryHit");
-
+    // All instances use the default shadow hit group unless overridden below.
     m_pSBT->BindHitGroupForTLAS(m_pTLAS, SHADOW_RAY_INDEX, nullptr);
 
-    for (int i = 0; i < NumLocalSpheres; ++i)
-        m_pSBT->BindHitGroupForInstance(m_pTLAS,
-                                        ("Sphere Instance " + std::to_string(i + 1)).c_str(),
-                                        SHADOW_RAY_INDEX, "SphereShadowHit");
+    std::vector<HitGroupBinding> Bindings;
+    WriteHitGroupBindings(m_CubeInstanceNames, m_SphereInstanceNames, Bindings);
+    for (const HitGroupBinding& Binding : Bindings)
+        m_pSBT->BindHitGroupForInstance(m_pTLAS, Binding.InstanceName, Binding.RayIndex, Binding.HitGroupName);
 
     m_pImmediateContext->UpdateSBT(m_pSBT);
 }
@@ -564,13 +952,46 @@ void Tutorial21_RayTracing::Initialize(const SampleInitInfo& InitInfo)
     m_pDevice->CreateBuffer(BuffDesc, nullptr, &m_ConstantsCB);
     VERIFY_EXPR(m_ConstantsCB != nullptr);
 
-    CreateGraphicsPSO();
-    CreateRayTracingPSO();
-    LoadTextures();
-    CreateCubeBLAS();
-    CreateProceduralBLAS();
-    UpdateTLAS();
-    CreateSBT();
+    BuffDesc.Name = "Temporal constant buffer";
+    BuffDesc.Size = sizeof(m_TemporalConstants);
+    m_pDevice->CreateBuffer(BuffDesc, nullptr, &m_TemporalCB);
+    VERIFY_EXPR(m_TemporalCB != nullptr);
+
+    m_CubeInstanceNames.Init("Cube Instance", NumCubes);
+    m_SphereInstanceNames.Init("Sphere Instance", NumSpheres);
+
+    // Shader compilation, texture decoding and geometry generation are independent and
+    // run concurrently. Device methods are thread-safe, but the immediate context is not,
+    // so commands are recorded under m_InitContextMtx. BLAS tasks only lock it around the
+    // build commands, the other tasks that record commands hold it for their whole duration.
+    {
+        auto WithContext = [this](auto Func) {
+            return [this, Func]() {
+                std::lock_guard<std::mutex> Lock{m_InitContextMtx};
+                Func();
+            };
+        };
+
+        TaskGraph InitGraph;
+
+        InitGraph.AddTask("CreateGraphicsPSO", [this]() { CreateGraphicsPSO(); });
+
+        const auto RayTracingPSO = InitGraph.AddTask("CreateRayTracingPSO", [this]() { CreateRayTracingPSO(); });
+        const auto Textures      = InitGraph.AddTask("LoadTextures", [this]() { LoadTextures(); });
+        const auto BlueNoise     = InitGraph.AddTask("CreateBlueNoiseTexture", [this]() { CreateBlueNoiseTexture(); });
+        const auto CubeBLAS      = InitGraph.AddTask("CreateCubeBLAS", [this]() { CreateCubeBLAS(); });
+        const auto ProcBLAS      = InitGraph.AddTask("CreateProceduralBLAS", [this]() { CreateProceduralBLAS(); });
+
+        InitGraph.AddTask("BindResources", WithContext([this]() { BindResources(); }),
+                          {RayTracingPSO, Textures, BlueNoise, CubeBLAS, ProcBLAS});
+
+        // UpdateTLAS binds the TLAS to the SRB, so it also depends on the PSO.
+        const auto TLAS = InitGraph.AddTask("UpdateTLAS", WithContext([this]() { UpdateTLAS(); }), {RayTracingPSO, CubeBLAS, ProcBLAS});
+        InitGraph.AddTask("CreateSBT", WithContext([this]() { CreateSBT(); }), {TLAS, RayTracingPSO});
+
+        InitGraph.Run();
+        InitGraph.LogTimings("Tutorial21 initialization");
+    }
 
     // Setup camera.
     m_Camera.SetPos(float3(7.f, -0.5f, -16.5f));
@@ -621,17 +1042,164 @@ void Tutorial21_RayTracing::Initialize(const SampleInitInfo& InitInfo)
         m_Constants.LightPos[1]   = {0.00f, +4.0f, -5.00f, 0.f};
         m_Constants.LightColor[1] = {0.85f, +1.0f, +0.85f, 0.f};
 
-        // Random points on disc.
-        m_Constants.DiscPoints[0] = {+0.0f, +0.0f, +0.9f, -0.9f};
-        m_Constants.DiscPoints[1] = {-0.8f, +1.0f, -1.1f, -0.8f};
-        m_Constants.DiscPoints[2] = {+1.5f, +1.2f, -2.1f, +0.7f};
-        m_Constants.DiscPoints[3] = {+0.1f, -2.2f, -0.2f, +2.4f};
-        m_Constants.DiscPoints[4] = {+2.4f, -0.3f, -3.0f, +2.8f};
-        m_Constants.DiscPoints[5] = {+2.0f, -2.6f, +0.7f, +3.5f};
-        m_Constants.DiscPoints[6] = {-3.2f, -1.6f, +3.4f, +2.2f};
-        m_Constants.DiscPoints[7] = {-1.8f, -3.2f, -1.1f, +3.6f};
+        // Points on disc.
+        UpdateDiscPoints();
+
+        if (m_NumLights > static_cast<int>(std::size(m_Constants.LightPos)))
+            GenerateExtraLights(static_cast<Uint32>(m_NumLights - static_cast<int>(std::size(m_Constants.LightPos))));
     }
     static_assert(sizeof(HLSL::Constants) % 16 == 0, "must be aligned by 16 bytes");
+
+    if (!m_CaptureFilePath.empty())
+    {
+        const SwapChainDesc& SCDesc = m_pSwapChain->GetDesc();
+        m_CaptureWriter.Open(m_CaptureFilePath.c_str(), SCDesc.Width, SCDesc.Height, sizeof(CapturedUIState));
+    }
+    else if (!m_ReplayFilePath.empty())
+    {
+        BeginReplay();
+    }
+
+    if (!m_DumpFramesPrefix.empty())
+    {
+        FrameReadback::CreateInfo ReadbackCI;
+        ReadbackCI.Encoder.Format       = m_DumpFramesFormat;
+        ReadbackCI.Encoder.OutputPrefix = m_DumpFramesPrefix;
+        ReadbackCI.Encoder.NumWorkers   = std::max(std::thread::hardware_concurrency() / 2u, 1u);
+        // PNG and EXR encoding allocates, but the encoders run off the frame path and are
+        // excluded from the --check_allocations count.
+        ReadbackCI.Encoder.OnWorkerStarted = []() { AllocationCounter::ExcludeCurrentThread(); };
+
+        m_pFrameReadback = std::make_unique<FrameReadback>(m_pDevice, m_pImmediateContext, ReadbackCI);
+    }
+}
+
+void Tutorial21_RayTracing::BeginReplay()
+{
+    if (!m_ReplayReader.Open(m_ReplayFilePath.c_str(), sizeof(CapturedUIState)))
+    {
+        if (m_ExitAfterReplay)
+            std::exit(EXIT_FAILURE);
+        return;
+    }
+
+    // Replay renders at the captured resolution regardless of the window size,
+    // ignores user input and hides the UI so that timings only depend on the build.
+    m_IsReplaying         = true;
+    m_AnimateBeforeReplay = m_Animate;
+    m_Animate             = false;
+    // The camera jumps to the captured pose, so the history can't be reprojected.
+    m_HasHistory = false;
+
+    if (m_pDevice->GetDeviceInfo().Features.TimestampQueries)
+        m_pTraceDurationQuery = std::make_unique<DurationQueryHelper>(m_pDevice, 4);
+
+    // Reserve all timing records up front so that replay frames do not allocate.
+    m_ReplayTimings.clear();
+    m_ReplayTimings.reserve(m_ReplayReader.GetFrameCount());
+    m_NumResolvedGPUTimings = 0;
+    m_LastReplayFrameTime   = std::chrono::steady_clock::now();
+
+    LOG_INFO_MESSAGE("Replaying '", m_ReplayFilePath, "' at ", m_ReplayReader.GetWidth(), "x", m_ReplayReader.GetHeight());
+}
+
+void Tutorial21_RayTracing::EndReplay()
+{
+    m_IsReplaying = false;
+    m_Animate     = m_AnimateBeforeReplay;
+    // The camera jumps back to the interactive one.
+    m_HasHistory = false;
+
+    // The replayed constants have overwritten the disc points.
+    m_DiscPointsValid = false;
+
+    bool Succeeded = true;
+
+    std::ofstream TimingsFile{m_ReplayTimingsFilePath, std::ios::out | std::ios::trunc};
+    if (!TimingsFile)
+    {
+        LOG_ERROR_MESSAGE("Failed to open '", m_ReplayTimingsFilePath, "' for writing");
+        Succeeded = false;
+    }
+    else
+    {
+        TimingsFile << "frame,cpu_frame_ms,gpu_trace_ms\n";
+        for (size_t i = 0; i < m_ReplayTimings.size(); ++i)
+            TimingsFile << i << ',' << m_ReplayTimings[i].CPUFrameTimeMs << ',' << m_ReplayTimings[i].GPUTraceTimeMs << '\n';
+    }
+
+    // The first frame includes the tail of the initialization and is excluded from the average.
+    double TotalCPUTimeMs = 0;
+    for (size_t i = 1; i < m_ReplayTimings.size(); ++i)
+        TotalCPUTimeMs += m_ReplayTimings[i].CPUFrameTimeMs;
+    const size_t NumTimedFrames = m_ReplayTimings.size() > 1 ? m_ReplayTimings.size() - 1 : 1;
+
+    LOG_INFO_MESSAGE("Replay finished: ", m_ReplayTimings.size(), " frames, average CPU frame time ",
+                     TotalCPUTimeMs / static_cast<double>(NumTimedFrames), " ms. Timings written to '", m_ReplayTimingsFilePath, "'");
+
+    m_pTraceDurationQuery.reset();
+
+    if (m_pFrameReadback)
+    {
+        // Write out every frame of the replay before reporting.
+        m_pFrameReadback->Flush();
+        LOG_INFO_MESSAGE("Dumped ", m_pFrameReadback->GetNumEncoded(), " frame(s) to '", m_DumpFramesPrefix, "*': ",
+                         m_pFrameReadback->GetNumSkipped(), " skipped, ", m_pFrameReadback->GetNumFailed(), " failed");
+        if (m_pFrameReadback->GetNumFailed() > 0)
+            Succeeded = false;
+    }
+
+    const bool AllocationCheckFailed = m_CheckAllocations && m_NumAllocatingFrames > 0;
+    if (m_CheckAllocations)
+    {
+        if (AllocationCheckFailed)
+            LOG_ERROR_MESSAGE("Allocation check failed: ", m_NumAllocatingFrames, " frame(s) performed heap allocations after warm-up");
+        else
+            LOG_INFO_MESSAGE("Allocation check passed: no heap allocations after warm-up");
+
+        // Writing the timings and resizing the color buffer allocate; restart the warm-up.
+        m_AllocCheckWarmupLeft = AllocCheckWarmupFrames;
+        m_NumAllocatingFrames  = 0;
+    }
+
+    if (m_ExitAfterReplay)
+    {
+        // Everything the run produces has been written at this point.
+        TimingsFile.close();
+        std::exit(Succeeded && !AllocationCheckFailed ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    VERIFY(!AllocationCheckFailed, "The frame loop must not allocate (see the log for the allocating frames)");
+
+    // Return to the window resolution.
+    const SwapChainDesc& SCDesc = m_pSwapChain->GetDesc();
+    WindowResize(SCDesc.Width, SCDesc.Height);
+}
+
+void Tutorial21_RayTracing::CheckFrameAllocations()
+{
+    if (!m_CheckAllocations)
+        return;
+
+    // The count is sampled at the start of every Update(), so the previous frame is covered
+    // as a whole, including the UI rendering and Present() that follow Render(). All threads
+    // except the frame encoder workers are counted: work that the frame hands off to other
+    // threads must not allocate either.
+    const Uint64 TotalCount     = AllocationCounter::GetTotalCount();
+    const Uint64 NumAllocations = TotalCount - m_FrameStartAllocationCount;
+    m_FrameStartAllocationCount = TotalCount;
+
+    // Resources, buffer pools and the frame arena reach their steady-state size during the first frames.
+    if (m_AllocCheckWarmupLeft > 0)
+    {
+        --m_AllocCheckWarmupLeft;
+        return;
+    }
+
+    if (NumAllocations != 0)
+    {
+        ++m_NumAllocatingFrames;
+        LOG_ERROR_MESSAGE("Frame ", m_FrameIndex - 1, " performed ", NumAllocations, " heap allocation(s)");
+    }
 }
 
 void Tutorial21_RayTracing::ModifyEngineInitInfo(const ModifyEngineInitInfoAttribs& Attribs)
@@ -640,25 +1208,77 @@ void Tutorial21_RayTracing::ModifyEngineInitInfo(const ModifyEngineInitInfoAttri
 
     // Require ray tracing feature.
     Attribs.EngineCI.Features.RayTracing = DEVICE_FEATURE_STATE_ENABLED;
+
+    // Timestamp queries are used to measure trace time during replay.
+    Attribs.EngineCI.Features.TimestampQueries = DEVICE_FEATURE_STATE_OPTIONAL;
 }
 
 // Render a frame
 void Tutorial21_RayTracing::Render()
 {
+    if (m_IsReplaying)
+    {
+        const auto Now = std::chrono::steady_clock::now();
+
+        ReplayFrameTiming Timing;
+        Timing.CPUFrameTimeMs = std::chrono::duration<double, std::milli>(Now - m_LastReplayFrameTime).count();
+        m_ReplayTimings.push_back(Timing);
+        m_LastReplayFrameTime = Now;
+    }
+
     UpdateTLAS();
+    UpdateLights();
 
     // Update constants
     {
-        float3   CameraWorldPos = float3::MakeVector(m_Camera.GetWorldMatrix()[3]);
-        float4x4 CameraViewProj = m_Camera.GetViewMatrix() * m_Camera.GetProjMatrix();
+        float3   CameraWorldPos;
+        float4x4 CameraView;
+        if (m_IsReplaying)
+        {
+            CameraWorldPos = m_ReplayFrame.CameraPos;
+            CameraView     = m_ReplayFrame.ViewMatrix;
+        }
+        else
+        {
+            CameraWorldPos = float3::MakeVector(m_Camera.GetWorldMatrix()[3]);
+            CameraView     = m_Camera.GetViewMatrix();
+        }
+        float4x4 CameraViewProj = CameraView * m_Camera.GetProjMatrix();
+
+        if (m_CaptureWriter.IsOpen())
+        {
+            // Camera data is stored separately, so exclude it from the constants
+            // to only record the values that were changed through the UI.
+            CapturedUIState UIState;
+            UIState.Constants             = m_Constants;
+            UIState.Constants.CameraPos   = {};
+            UIState.Constants.InvViewProj = {};
+            UIState.HistoryWeight         = m_TemporalConstants.HistoryWeight;
+            UIState.SecondaryRayInterval  = m_TemporalConstants.SecondaryRayInterval;
+            UIState.EnableTemporalReuse   = m_EnableTemporalReuse ? 1 : 0;
+            UIState.NumLights             = static_cast<Uint32>(m_NumLights);
+            m_CaptureWriter.WriteFrame(m_AnimationTime, CameraWorldPos, CameraView, &UIState);
+        }
 
-        m_Constants.CameraPos   = float4{CameraWorldPos, 1.0f};
-        m_Constants.InvViewProj = CameraViewProj.Inverse();
+        UpdateCameraConstants(CameraWorldPos, CameraViewProj, m_Constants);
 
         m_pImmediateContext->UpdateBuffer(m_ConstantsCB, 0, sizeof(m_Constants), &m_Constants, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+        UpdateTemporalReuse(CameraWorldPos, CameraViewProj);
+
+        if (m_MultiViewMode != MULTI_VIEW_MODE_NONE)
+            UpdateMultiViews(CameraWorldPos, CameraView);
     }
 
     // Trace rays
+    if (m_MultiViewMode != MULTI_VIEW_MODE_NONE)
+    {
+        const bool   IsCubemap = m_MultiViewMode == MULTI_VIEW_MODE_CUBEMAP;
+        const Uint32 Width     = IsCubemap ? m_MultiViewSize : m_pColorRT->GetDesc().Width;
+        const Uint32 Height    = IsCubemap ? m_MultiViewSize : m_pColorRT->GetDesc().Height;
+        TraceMultiView(m_MultiViews, m_NumMultiViews, Width, Height);
+    }
+    else
     {
         m_pRayTracingSRB->GetVariableByName(SHADER_TYPE_RAY_GEN, "g_ColorBuffer")->Set(m_pColorRT->GetDefaultView(TEXTURE_VIEW_UNORDERED_ACCESS));
 
@@ -669,13 +1289,18 @@ void Tutorial21_RayTracing::Render()
         Attribs.DimensionX = m_pColorRT->GetDesc().Width;
         Attribs.DimensionY = m_pColorRT->GetDesc().Height;
         Attribs.pSBT       = m_pSBT;
+        TraceRays(Attribs);
+    }
 
-        m_pImmediateContext->TraceRays(Attribs);
+    if (m_pFrameReadback)
+    {
+        m_pFrameReadback->Poll();
+        m_pFrameReadback->Capture(GetOutputTexture(), m_FrameIndex);
     }
 
     // Blit to swapchain image
     {
-        m_pImageBlitSRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(m_pColorRT->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE));
+        m_pImageBlitSRB->GetVariableByName(SHADER_TYPE_PIXEL, "g_Texture")->Set(GetOutputTexture()->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE));
 
         ITextureView* pRTV = m_pSwapChain->GetCurrentBackBufferRTV();
         m_pImmediateContext->SetRenderTargets(1, &pRTV, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
@@ -685,17 +1310,53 @@ void Tutorial21_RayTracing::Render()
 
         m_pImmediateContext->Draw(DrawAttribs{3, DRAW_FLAG_VERIFY_ALL});
     }
+
+    ++m_FrameIndex;
 }
 
 void Tutorial21_RayTracing::Update(double CurrTime, double ElapsedTime, bool DoUpdateUI)
 {
+    m_FrameArena.Reset();
+    CheckFrameAllocations();
+
     SampleBase::Update(CurrTime, ElapsedTime);
 
+    if (m_IsReplaying)
+    {
+        // Advance exactly one captured frame per rendered frame, independent of the wall clock.
+        CapturedUIState UIState;
+        if (m_ReplayReader.ReadFrame(m_ReplayFrame, &UIState))
+        {
+            if ((m_ReplayFrame.Flags & SCENE_CAPTURE_FRAME_FLAG_CONSTANTS) != 0)
+            {
+                m_Constants                              = UIState.Constants;
+                m_TemporalConstants.HistoryWeight        = UIState.HistoryWeight;
+                m_TemporalConstants.SecondaryRayInterval = UIState.SecondaryRayInterval;
+                m_EnableTemporalReuse                    = UIState.EnableTemporalReuse != 0;
+
+                const int NumSceneLights = static_cast<int>(std::size(m_Constants.LightPos));
+                const int NumLights      = std::min(std::max(static_cast<int>(UIState.NumLights), NumSceneLights), static_cast<int>(MaxLights));
+                if (NumLights != m_NumLights)
+                {
+                    m_NumLights = NumLights;
+                    GenerateExtraLights(static_cast<Uint32>(m_NumLights - NumSceneLights));
+                    // Changing the light count allocates, so the allocation check starts over.
+                    m_AllocCheckWarmupLeft = AllocCheckWarmupFrames;
+                }
+            }
+            m_AnimationTime = m_ReplayFrame.AnimationTime;
+            return;
+        }
+        EndReplay();
+    }
+
     if (m_Animate)
     {
         m_AnimationTime += static_cast<float>(std::min(m_MaxAnimationTimeDelta, ElapsedTime));
     }
 
+    UpdateDiscPoints();
+
     m_Camera.Update(m_InputController, static_cast<float>(ElapsedTime));
 
     // Do not allow going underground
@@ -713,6 +1374,18 @@ void Tutorial21_RayTracing::WindowResize(Uint32 Width, Uint32 Height)
     if (Width == 0 || Height == 0)
         return;
 
+    if (m_IsReplaying)
+    {
+        Width  = m_ReplayReader.GetWidth();
+        Height = m_ReplayReader.GetHeight();
+    }
+    else if (m_CaptureWriter.IsOpen())
+    {
+        // The capture only records one resolution, so keep rendering at it and stretch the image to the window.
+        Width  = m_CaptureWriter.GetWidth();
+        Height = m_CaptureWriter.GetHeight();
+    }
+
     // Update projection matrix.
     float AspectRatio = static_cast<float>(Width) / static_cast<float>(Height);
     m_Camera.SetProjAttribs(m_Constants.ClipPlanes.x, m_Constants.ClipPlanes.y, AspectRatio, PI_F / 4.f,
@@ -725,6 +1398,8 @@ void Tutorial21_RayTracing::WindowResize(Uint32 Width, Uint32 Height)
         return;
 
     m_pColorRT = nullptr;
+    // Recreating the color buffer allocates, so the allocation check starts over.
+    m_AllocCheckWarmupLeft = AllocCheckWarmupFrames;
 
     // Create window-size color image.
     TextureDesc RTDesc       = {};
@@ -737,6 +1412,32 @@ void Tutorial21_RayTracing::WindowResize(Uint32 Width, Uint32 Height)
     RTDesc.Format            = m_ColorBufferFormat;
 
     m_pDevice->CreateTexture(RTDesc, nullptr, &m_pColorRT);
+
+    m_HasHistory = false;
+    if (!m_TemporalReuseSupported)
+        return;
+
+    // Temporal reuse buffers. The history of the previous resolution can't be reprojected.
+    RTDesc.Name              = "Motion vectors";
+    RTDesc.Format            = TEX_FORMAT_RG16_FLOAT;
+    RTDesc.ClearValue.Format = RTDesc.Format;
+    m_pMotionVectorsRT.Release();
+    m_pDevice->CreateTexture(RTDesc, nullptr, &m_pMotionVectorsRT);
+
+    for (Uint32 i = 0; i < 2; ++i)
+    {
+        // Shading results are accumulated in linear HDR space before tone mapping.
+        RTDesc.Name              = "History color";
+        RTDesc.Format            = TEX_FORMAT_RGBA16_FLOAT;
+        RTDesc.ClearValue.Format = RTDesc.Format;
+        m_pHistoryRT[i].Release();
+        m_pDevice->CreateTexture(RTDesc, nullptr, &m_pHistoryRT[i]);
+
+        // World-space normal in XYZ, primary hit distance in W.
+        RTDesc.Name = "Surface";
+        m_pSurfaceRT[i].Release();
+        m_pDevice->CreateTexture(RTDesc, nullptr, &m_pSurfaceRT[i]);
+    }
 }
 
 void Tutorial21_RayTracing::UpdateUI()
@@ -744,6 +1445,9 @@ void Tutorial21_RayTracing::UpdateUI()
     const float MaxIndexOfRefraction = 2.0f;
     const float MaxDispersion        = 0.5f;
 
+    if (m_IsReplaying)
+        return;
+
     ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
     if (ImGui::Begin("Settings", nullptr, ImGuiWindowFlags_AlwaysAutoResize))
     {
@@ -751,12 +1455,38 @@ void Tutorial21_RayTracing::UpdateUI()
 
         ImGui::Text("Use WASD to move camera");
         ImGui::SliderInt("Shadow blur", &m_Constants.ShadowPCF, 0, 16);
+        ImGui::Checkbox("Animate sample pattern", &m_AnimateSamplePattern);
         ImGui::SliderInt("Max recursion", &m_Constants.MaxRecursion, 0, m_MaxRecursionDepth);
+        {
+            const int NumSceneLights = static_cast<int>(std::size(m_Constants.LightPos));
+            if (ImGui::SliderInt("Lights", &m_NumLights, NumSceneLights, static_cast<int>(MaxLights)))
+                GenerateExtraLights(static_cast<Uint32>(m_NumLights - NumSceneLights));
+        }
+
+        if (m_MultiViewMode != MULTI_VIEW_MODE_NONE)
+        {
+            ImGui::SliderInt("Preview view", &m_MultiViewPreview, 0, static_cast<int>(std::max(m_NumMultiViews, 1u)) - 1);
+            if (m_MultiViewMode == MULTI_VIEW_MODE_STEREO)
+                ImGui::SliderFloat("Eye separation", &m_EyeSeparation, 0.0f, 0.5f);
+        }
+
+        if (m_TemporalReuseSupported)
+        {
+            ImGui::Checkbox("Temporal reuse", &m_EnableTemporalReuse);
+            if (m_EnableTemporalReuse)
+            {
+                ImGui::SliderFloat("History weight", &m_TemporalConstants.HistoryWeight, 0.0f, 0.98f);
+
+                int SecondaryRayInterval = static_cast<int>(m_TemporalConstants.SecondaryRayInterval);
+                ImGui::SliderInt("Secondary ray interval", &SecondaryRayInterval, 1, 8);
+                m_TemporalConstants.SecondaryRayInterval = static_cast<Uint32>(SecondaryRayInterval);
+            }
+        }
 
         // Ahora mostramos 16 checkboxes, uno por cada cubo
         for (int i = 0; i < NumCubes; ++i)
         {
-            ImGui::Checkbox(("Cube " + std::to_string(i + 1)).c_str(), &m_EnableCubes[i]);
+            ImGui::Checkbox(m_FrameArena.Format("Cube %d", i + 1), &m_EnableCubes[i]);
             if ((i + 1) % 8 != 0) 
                 ImGui::SameLine();
         }
@@ -773,7 +1503,7 @@ void Tutorial21_RayTracing::UpdateUI()
             m_Constants.GlassIndexOfRefraction.y = m_Constants.GlassIndexOfRefraction.x + m_DispersionFactor;
 
             int rsamples = PlatformMisc::GetLSB(m_Constants.DispersionSampleCount);
-            ImGui::SliderInt("Dispersion samples", &rsamples, 1, PlatformMisc::GetLSB(Uint32{MAX_DISPERS_SAMPLES}), std::to_string(1 << rsamples).c_str());
+            ImGui::SliderInt("Dispersion samples", &rsamples, 1, PlatformMisc::GetLSB(Uint32{MAX_DISPERS_SAMPLES}), m_FrameArena.Format("%d", 1 << rsamples));
             m_Constants.DispersionSampleCount = 1u << rsamples;
         }
 
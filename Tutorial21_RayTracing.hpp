@@ -30,18 +30,28 @@
 #include "SampleBase.hpp"
 #include "BasicMath.hpp"
 #include "FirstPersonCamera.hpp"
+#include "DurationQueryHelper.hpp"
+#include "SceneCapture.hpp"
+#include "SceneBuilder.hpp"
+#include "FrameReadback.hpp"
+#include "LightBVH.hpp"
+#include "FrameArena.hpp"
+#include "Reprojection.hpp"
+#include "MultiView.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace Diligent
 {
 
-namespace HLSL
-{
-#include "../assets/structures.fxh"
-}
-
 class Tutorial21_RayTracing final : public SampleBase
 {
 public:
+    virtual CommandLineStatus ProcessCommandLine(int argc, const char* const* argv) override final;
     virtual void ModifyEngineInitInfo(const ModifyEngineInitInfoAttribs& Attribs) override final;
     virtual void Initialize(const SampleInitInfo& InitInfo) override final;
 
@@ -52,6 +62,10 @@ public:
 
     virtual void WindowResize(Uint32 Width, Uint32 Height) override final;
 
+    /// Sets the lights that follow the two scene lights in the light buffer. Only hit shaders
+    /// that select lights through g_LightBVH see them. The light count is limited to MaxLights.
+    void SetExtraLights(const LightAttribs* pLights, Uint32 NumLights);
+
 protected:
     virtual void UpdateUI()  final;
 
@@ -61,11 +75,29 @@ private:
     void CreateCubeBLAS();
     void CreateProceduralBLAS();
     void UpdateTLAS();
+    void UpdateLights();
+    void GenerateExtraLights(Uint32 NumLights);
     void CreateSBT();
     void LoadTextures();
+    void BindResources();
+    void CreateBlueNoiseTexture();
+    void UpdateDiscPoints();
+    void UpdateTemporalReuse(const float3& CameraPos, const float4x4& ViewProj);
+    void UpdateMultiViews(const float3& CameraPos, const float4x4& CameraView);
+    void TraceMultiView(const MultiViewCamera* pViews, Uint32 NumViews, Uint32 Width, Uint32 Height);
+    void TraceRays(const TraceRaysAttribs& Attribs);
+
+    // Texture that is blitted to the swap chain and dumped: the previewed view in multi-view mode.
+    ITexture* GetOutputTexture() const { return m_MultiViewMode != MULTI_VIEW_MODE_NONE ? m_pMultiViewPreviewRT.RawPtr() : m_pColorRT.RawPtr(); }
+
+    void BeginReplay();
+    void EndReplay();
+
+    void CheckFrameAllocations();
 
     static constexpr int NumTextures = 4;
     static constexpr int NumCubes    = 16;
+    static constexpr int NumSpheres  = 16;
 
     bool m_EnableCubes[NumCubes] = {};
 
@@ -73,6 +105,9 @@ private:
     RefCntAutoPtr<IBuffer> m_BoxAttribsCB;
     RefCntAutoPtr<IBuffer> m_ConstantsCB;
 
+    RefCntAutoPtr<ITexture> m_pCubeTextures[NumTextures];
+    RefCntAutoPtr<ITexture> m_pGroundTex;
+
     RefCntAutoPtr<IPipelineState>         m_pRayTracingPSO;
     RefCntAutoPtr<IShaderResourceBinding> m_pRayTracingSRB;
 
@@ -86,12 +121,32 @@ private:
     RefCntAutoPtr<IBuffer>             m_ScratchBuffer;
     RefCntAutoPtr<IShaderBindingTable> m_pSBT;
 
+    InstanceNameTable m_CubeInstanceNames;
+    InstanceNameTable m_SphereInstanceNames;
+
+    // Serializes immediate context calls of the concurrent initialization tasks.
+    std::mutex m_InitContextMtx;
+
+    static constexpr Uint32 MaxLights = 1024;
+
+    // Scene lights from m_Constants followed by the extra lights
+    std::vector<LightAttribs> m_Lights;
+    bool                      m_LightsDirty = true;
+    int                       m_NumLights   = 2; // Total light count set by --num_lights or the UI
+    LightBVH                  m_LightBVH;
+    RefCntAutoPtr<IBuffer>    m_LightsBuffer;
+    RefCntAutoPtr<IBuffer>    m_LightBVHBuffer;
+
     Uint32          m_MaxRecursionDepth     = 8;
     const double    m_MaxAnimationTimeDelta = 1.0 / 60.0;
     float           m_AnimationTime         = 0.0f;
+    Uint64          m_FrameIndex            = 0;
     HLSL::Constants m_Constants             = {};
     bool            m_EnableCubes[NumCubes] = {true, true, true, true};
     bool            m_Animate               = true;
+    bool            m_AnimateSamplePattern  = false;
+    bool            m_DiscPointsValid       = false;
+    Uint32          m_DiscPointsSeed        = 0;
     float           m_DispersionFactor      = 0.1f;
 
 
@@ -99,6 +154,92 @@ private:
 
     TEXTURE_FORMAT          m_ColorBufferFormat = TEX_FORMAT_RGBA8_UNORM;
     RefCntAutoPtr<ITexture> m_pColorRT;
+    RefCntAutoPtr<ITexture> m_pBlueNoiseTex;
+
+    // Temporal reuse of shading results (see Reprojection.hpp). History and surface buffers
+    // are ping-ponged: every frame writes one of them and reads the previous frame from the other.
+    RefCntAutoPtr<ITexture> m_pMotionVectorsRT;
+    RefCntAutoPtr<ITexture> m_pHistoryRT[2];
+    RefCntAutoPtr<ITexture> m_pSurfaceRT[2];
+    RefCntAutoPtr<IBuffer>  m_TemporalCB;
+    TemporalConstants       m_TemporalConstants;
+    float4x4                m_PrevViewProj;
+    float3                  m_PrevCameraPos;
+    bool                    m_HasHistory             = false;
+    bool                    m_EnableTemporalReuse    = false;
+    bool                    m_TemporalReuseSupported = false; // Ray generation shader declares the buffers
+
+    // Batched multi-view rendering (see --multi_view command line option). All views are
+    // traced in a single dispatch into the slices of m_pMultiViewRT; the TLAS is shared.
+    enum MULTI_VIEW_MODE
+    {
+        MULTI_VIEW_MODE_NONE = 0,
+        MULTI_VIEW_MODE_CUBEMAP,
+        MULTI_VIEW_MODE_STEREO
+    };
+    static constexpr Uint32 MaxMultiViews = 16;
+
+    MULTI_VIEW_MODE         m_MultiViewMode = MULTI_VIEW_MODE_NONE;
+    Uint32                  m_MultiViewSize = 512; // Cubemap face size
+    float                   m_EyeSeparation = 0.064f;
+    MultiViewCamera         m_MultiViews[MaxMultiViews];
+    MultiViewAttribs        m_MultiViewAttribs[MaxMultiViews];
+    Uint32                  m_NumMultiViews    = 0;
+    int                     m_MultiViewPreview = 0;
+    RefCntAutoPtr<IBuffer>  m_MultiViewBuffer;
+    RefCntAutoPtr<ITexture> m_pMultiViewRT;
+    RefCntAutoPtr<ITexture> m_pMultiViewPreviewRT;
+
+    // Deterministic capture & replay (see --capture and --replay command line options).
+    struct ReplayFrameTiming
+    {
+        double CPUFrameTimeMs = 0;
+        double GPUTraceTimeMs = -1;
+    };
+
+    // UI state stored in the capture: the shader constants and the temporal reuse and light
+    // count settings that are not part of them.
+    struct CapturedUIState
+    {
+        HLSL::Constants Constants;
+        float           HistoryWeight        = 0;
+        Uint32          SecondaryRayInterval = 0;
+        Uint32          EnableTemporalReuse  = 0;
+        Uint32          NumLights            = 0;
+    };
+
+    std::string m_CaptureFilePath;
+    std::string m_ReplayFilePath;
+    std::string m_ReplayTimingsFilePath = "replay_timings.csv";
+    bool        m_ExitAfterReplay       = false;
+
+    SceneCaptureWriter m_CaptureWriter;
+    SceneCaptureReader m_ReplayReader;
+
+    bool                    m_IsReplaying         = false;
+    bool                    m_AnimateBeforeReplay = true; // Restored when the replay ends
+    SceneCaptureFrameHeader m_ReplayFrame;
+
+    std::unique_ptr<DurationQueryHelper>  m_pTraceDurationQuery;
+    std::vector<ReplayFrameTiming>        m_ReplayTimings;
+    size_t                                m_NumResolvedGPUTimings = 0;
+    std::chrono::steady_clock::time_point m_LastReplayFrameTime;
+
+    // Asynchronous dump of the color buffer (see --dump_frames command line option).
+    std::string                    m_DumpFramesPrefix;
+    FRAME_ENCODE_FORMAT            m_DumpFramesFormat = FRAME_ENCODE_FORMAT_PNG;
+    std::unique_ptr<FrameReadback> m_pFrameReadback;
+
+    // Transient per-frame CPU data such as UI labels. Reset at the start of every frame.
+    FrameArena m_FrameArena;
+
+    // Heap allocation check of the frame loop (see --check_allocations command line option).
+    static constexpr Uint32 AllocCheckWarmupFrames = 16;
+
+    bool   m_CheckAllocations          = false;
+    Uint32 m_AllocCheckWarmupLeft      = AllocCheckWarmupFrames;
+    Uint64 m_FrameStartAllocationCount = 0;
+    Uint64 m_NumAllocatingFrames       = 0;
 };
 
 } // namespace Diligent
@@ -0,0 +1,1049 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// Device-independent tests of the CPU-side helpers of the tutorial.
+//
+// Usage:
+//   Tutorial21_Tests [<name filter>]
+//
+// Runs every test whose name contains the filter (all tests by default) and returns
+// a non-zero exit code if any check fails.
+//
+// Build: a separate console executable next to Tutorial21_RayTracing, never compiled into the sample
+// (it defines main()). Sources: Tutorial21_Tests.cpp, FrameEncoder.cpp, Denoiser.cpp, WorkerPool.cpp,
+// SampleSequences.cpp, Reprojection.cpp, MultiView.cpp, LightBVH.cpp. Only needs the Diligent-Common and
+// Diligent-Primitives headers (BasicMath.hpp, DebugUtilities.hpp).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Denoiser.hpp"
+#include "FrameEncoder.hpp"
+#include "LightBVH.hpp"
+#include "MultiView.hpp"
+#include "Reprojection.hpp"
+#include "SampleSequences.hpp"
+#include "WorkerPool.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+Uint32 g_NumFailedChecks = 0;
+
+#define TUTORIAL21_CHECK(Expr)                                                      \
+    do                                                                              \
+    {                                                                               \
+        if (!(Expr))                                                                \
+        {                                                                           \
+            std::printf("  %s(%d): check failed: %s\n", __FILE__, __LINE__, #Expr); \
+            ++g_NumFailedChecks;                                                    \
+        }                                                                           \
+    } while (false)
+
+Uint32 ReadU32BE(const Uint8* pData)
+{
+    return (Uint32{pData[0]} << 24u) | (Uint32{pData[1]} << 16u) | (Uint32{pData[2]} << 8u) | Uint32{pData[3]};
+}
+
+template <typename T>
+T ReadLE(const Uint8* pData)
+{
+    T Value;
+    std::memcpy(&Value, pData, sizeof(T));
+    return Value;
+}
+
+// Bitwise CRC-32, independent of the table used by the encoder.
+Uint32 ComputeCRC32(const Uint8* pData, size_t Size)
+{
+    Uint32 CRC = 0xFFFFFFFFu;
+    for (size_t i = 0; i < Size; ++i)
+    {
+        CRC ^= pData[i];
+        for (int k = 0; k < 8; ++k)
+            CRC = (CRC & 1u) ? 0xEDB88320u ^ (CRC >> 1u) : CRC >> 1u;
+    }
+    return CRC ^ 0xFFFFFFFFu;
+}
+
+// Returns a deterministic RGBA8 test image that has a different value in every channel.
+std::vector<Uint8> MakeTestImage(Uint32 Width, Uint32 Height, Uint32 Seed)
+{
+    std::vector<Uint8> Pixels(size_t{Width} * Height * 4);
+    for (size_t i = 0; i < Pixels.size(); ++i)
+        Pixels[i] = static_cast<Uint8>((i * 7u + Seed * 31u + (i >> 10u)) & 0xFFu);
+    return Pixels;
+}
+
+// Decodes a PNG written by EncodeFrame(): checks the chunk CRCs and inflates
+// the stored deflate blocks. Returns false if the file is malformed.
+bool DecodeStoredPNG(const std::vector<Uint8>& PNG, Uint32& Width, Uint32& Height, std::vector<Uint8>& Pixels)
+{
+    static constexpr Uint8 Signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (PNG.size() < sizeof(Signature) || std::memcmp(PNG.data(), Signature, sizeof(Signature)) != 0)
+        return false;
+
+    std::vector<Uint8> ZLib;
+    bool               HasIEND = false;
+    for (size_t Offset = sizeof(Signature); Offset + 12 <= PNG.size() && !HasIEND;)
+    {
+        const Uint32 Size = ReadU32BE(&PNG[Offset]);
+        if (Offset + 12 + Size > PNG.size())
+            return false;
+
+        const Uint8* pType = &PNG[Offset + 4];
+        const Uint8* pData = pType + 4;
+        if (ComputeCRC32(pType, Size + 4) != ReadU32BE(pData + Size))
+            return false;
+
+        if (std::memcmp(pType, "IHDR", 4) == 0)
+        {
+            Width  = ReadU32BE(pData);
+            Height = ReadU32BE(pData + 4);
+            if (pData[8] != 8 || pData[9] != 6)
+                return false;
+        }
+        else if (std::memcmp(pType, "IDAT", 4) == 0)
+            ZLib.insert(ZLib.end(), pData, pData + Size);
+        else if (std::memcmp(pType, "IEND", 4) == 0)
+            HasIEND = true;
+
+        Offset += 12 + Size;
+    }
+    if (!HasIEND || ZLib.size() < 6 || ((Uint32{ZLib[0]} << 8u) | ZLib[1]) % 31 != 0)
+        return false;
+
+    std::vector<Uint8> Filtered;
+    size_t             Offset = 2;
+    for (bool Final = false; !Final;)
+    {
+        if (Offset + 5 > ZLib.size() || (ZLib[Offset] & 0x6u) != 0)
+            return false;
+        Final             = (ZLib[Offset] & 1u) != 0;
+        const Uint16 Len  = ReadLE<Uint16>(&ZLib[Offset + 1]);
+        const Uint16 NLen = ReadLE<Uint16>(&ZLib[Offset + 3]);
+        if (static_cast<Uint16>(~NLen) != Len || Offset + 5 + Len > ZLib.size())
+            return false;
+        Filtered.insert(Filtered.end(), ZLib.begin() + Offset + 5, ZLib.begin() + Offset + 5 + Len);
+        Offset += 5 + Len;
+    }
+
+    Uint32 Adler1 = 1, Adler2 = 0;
+    for (Uint8 Byte : Filtered)
+    {
+        Adler1 = (Adler1 + Byte) % 65521u;
+        Adler2 = (Adler2 + Adler1) % 65521u;
+    }
+    if (Offset + 4 > ZLib.size() || ReadU32BE(&ZLib[Offset]) != ((Adler2 << 16u) | Adler1))
+        return false;
+
+    const size_t RowSize = size_t{Width} * 4;
+    if (Filtered.size() != (RowSize + 1) * Height)
+        return false;
+
+    Pixels.clear();
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        const Uint8* pRow = &Filtered[y * (RowSize + 1)];
+        if (pRow[0] != 0) // Only the "none" filter is expected
+            return false;
+        Pixels.insert(Pixels.end(), pRow + 1, pRow + 1 + RowSize);
+    }
+    return true;
+}
+
+void TestEncodeFrameRaw()
+{
+    const std::vector<Uint8> Pixels = MakeTestImage(13, 7, 1);
+
+    std::vector<Uint8> Encoded;
+    EncodeFrame(FRAME_ENCODE_FORMAT_RAW, Pixels.data(), 13, 7, Encoded);
+    TUTORIAL21_CHECK(Encoded == Pixels);
+}
+
+void TestEncodeFramePNG()
+{
+    // 160x120 needs two stored deflate blocks.
+    for (Uint32 Size : {1u, 17u, 160u})
+    {
+        const Uint32             Width  = Size;
+        const Uint32             Height = Size * 3 / 4 + 1;
+        const std::vector<Uint8> Pixels = MakeTestImage(Width, Height, Size);
+
+        std::vector<Uint8> Encoded;
+        EncodeFrame(FRAME_ENCODE_FORMAT_PNG, Pixels.data(), Width, Height, Encoded);
+
+        Uint32             DecodedWidth  = 0;
+        Uint32             DecodedHeight = 0;
+        std::vector<Uint8> Decoded;
+        TUTORIAL21_CHECK(DecodeStoredPNG(Encoded, DecodedWidth, DecodedHeight, Decoded));
+        TUTORIAL21_CHECK(DecodedWidth == Width && DecodedHeight == Height);
+        TUTORIAL21_CHECK(Decoded == Pixels);
+    }
+}
+
+void TestEncodeFrameEXR()
+{
+    constexpr Uint32         Width  = 9;
+    constexpr Uint32         Height = 5;
+    const std::vector<Uint8> Pixels = MakeTestImage(Width, Height, 2);
+
+    std::vector<Uint8> Encoded;
+    EncodeFrame(FRAME_ENCODE_FORMAT_EXR, Pixels.data(), Width, Height, Encoded);
+    TUTORIAL21_CHECK(Encoded.size() > 8 && ReadLE<Uint32>(Encoded.data()) == 20000630u);
+
+    // Scanlines are at the end of the file: y, data size and the A, B, G, R planes.
+    const size_t LineSize = 8 + size_t{Width} * 4 * sizeof(float);
+    TUTORIAL21_CHECK(Encoded.size() > LineSize * Height + Height * sizeof(Uint64));
+    const size_t FirstLine = Encoded.size() - LineSize * Height;
+    TUTORIAL21_CHECK(ReadLE<Uint64>(&Encoded[FirstLine - Height * sizeof(Uint64)]) == FirstLine);
+
+    static constexpr Uint32 ChannelOffsets[] = {3, 2, 1, 0};
+    bool                    AllMatch         = true;
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        const Uint8* pLine = &Encoded[FirstLine + y * LineSize];
+        AllMatch           = AllMatch && ReadLE<Int32>(pLine) == static_cast<Int32>(y);
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            for (Uint32 x = 0; x < Width; ++x)
+            {
+                const float Value = ReadLE<float>(pLine + 8 + (c * Width + x) * sizeof(float));
+                AllMatch          = AllMatch && Value == static_cast<float>(Pixels[(y * Width + x) * 4 + ChannelOffsets[c]]) / 255.f;
+            }
+        }
+    }
+    TUTORIAL21_CHECK(AllMatch);
+}
+
+void TestFrameEncodeQueue()
+{
+    constexpr Uint32 Width     = 32;
+    constexpr Uint32 Height    = 16;
+    constexpr Uint32 NumFrames = 64;
+
+    std::mutex          Mtx;
+    std::vector<Uint32> NumTimesEncoded(NumFrames);
+    Uint32              NumMismatches = 0;
+    std::atomic<Uint32> NumWorkersStarted{0};
+
+    FrameEncodeQueue::CreateInfo CI;
+    CI.Format     = FRAME_ENCODE_FORMAT_RAW;
+    CI.NumWorkers = 3;
+    CI.Capacity   = 4;
+
+    CI.OnWorkerStarted = [&]() { NumWorkersStarted.fetch_add(1); };
+    CI.OnEncoded       = [&](const FrameEncodeJob& Job, const std::vector<Uint8>& Encoded) {
+        std::lock_guard<std::mutex> Lock{Mtx};
+        if (Job.FrameIndex < NumFrames)
+            ++NumTimesEncoded[static_cast<size_t>(Job.FrameIndex)];
+        if (Job.Width != Width || Job.Height != Height ||
+            Encoded != MakeTestImage(Width, Height, static_cast<Uint32>(Job.FrameIndex)))
+            ++NumMismatches;
+    };
+
+    {
+        FrameEncodeQueue Queue{CI};
+        for (Uint32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            const std::vector<Uint8> Pixels = MakeTestImage(Width, Height, Frame);
+
+            FrameEncodeJob Job;
+            Job.FrameIndex = Frame;
+            Job.Width      = Width;
+            Job.Height     = Height;
+            Job.Pixels     = Queue.AcquireBuffer(Pixels.size());
+            std::memcpy(Job.Pixels.data(), Pixels.data(), Pixels.size());
+
+            // The producer never blocks: retry while the queue is full.
+            while (!Queue.TryPush(Job))
+            {
+                TUTORIAL21_CHECK(Job.Pixels.size() == Pixels.size());
+                std::this_thread::sleep_for(std::chrono::microseconds{100});
+            }
+        }
+        Queue.WaitIdle();
+
+        TUTORIAL21_CHECK(Queue.GetNumEncoded() == NumFrames);
+        TUTORIAL21_CHECK(Queue.GetNumFailed() == 0);
+    }
+
+    bool AllEncodedOnce = true;
+    for (Uint32 Count : NumTimesEncoded)
+        AllEncodedOnce = AllEncodedOnce && Count == 1;
+    TUTORIAL21_CHECK(AllEncodedOnce);
+    TUTORIAL21_CHECK(NumMismatches == 0);
+    TUTORIAL21_CHECK(NumWorkersStarted.load() == CI.NumWorkers);
+}
+
+void TestWorkerPool()
+{
+    WorkerPool Pool{4};
+
+    // Every item must be visited exactly once, for any chunk count, including nested loops.
+    for (Uint32 NumChunks : {0u, 1u, 3u, 1000u})
+    {
+        std::vector<std::atomic<Uint32>> Visits(997);
+        Pool.ParallelFor(
+            static_cast<Uint32>(Visits.size()), [&](Uint32 First, Uint32 End) {
+                for (Uint32 i = First; i < End; ++i)
+                    Visits[i].fetch_add(1);
+                Pool.ParallelFor(1, [](Uint32, Uint32) {});
+            },
+            NumChunks);
+
+        bool AllVisitedOnce = true;
+        for (const std::atomic<Uint32>& Count : Visits)
+            AllVisitedOnce = AllVisitedOnce && Count.load() == 1;
+        TUTORIAL21_CHECK(AllVisitedOnce);
+    }
+}
+
+// Soft shadow of a sphere cast by a disc light onto a floor, next to an unshadowed wall,
+// rendered with a given number of random light samples per pixel.
+struct SoftShadowScene
+{
+    static constexpr Uint32 Width  = 160;
+    static constexpr Uint32 Height = 120;
+
+    std::vector<float> Depth;
+    std::vector<float> Normals;
+
+    SoftShadowScene() :
+        Depth(Width * Height),
+        Normals(Width * Height * 4)
+    {
+        for (Uint32 y = 0; y < Height; ++y)
+        {
+            for (Uint32 x = 0; x < Width; ++x)
+            {
+                const Uint32 Idx    = y * Width + x;
+                const bool   IsWall = IsWallPixel(x);
+
+                Depth[Idx]           = IsWall ? 3.f : 2.f + 10.f * static_cast<float>(y) / Height;
+                Normals[Idx * 4 + 0] = IsWall ? 1.f : 0.f;
+                Normals[Idx * 4 + 1] = IsWall ? 0.f : 1.f;
+            }
+        }
+    }
+
+    static bool IsWallPixel(Uint32 x) { return x < Width / 5; }
+
+    std::vector<float> Render(Uint32 NumSamples, Uint32 Seed) const
+    {
+        std::mt19937                          Rng{Seed};
+        std::uniform_real_distribution<float> Rand{0.f, 1.f};
+
+        std::vector<float> Color(Width * Height * 4);
+        for (Uint32 y = 0; y < Height; ++y)
+        {
+            for (Uint32 x = 0; x < Width; ++x)
+            {
+                float* pColor = &Color[(y * Width + x) * 4];
+                pColor[3]     = 1.f;
+                if (IsWallPixel(x))
+                {
+                    pColor[0] = 0.2f;
+                    pColor[1] = 0.4f;
+                    pColor[2] = 0.8f;
+                    continue;
+                }
+
+                // Floor point
+                const float Px = 10.f * static_cast<float>(x) / Width - 5.f;
+                const float Pz = 10.f * static_cast<float>(y) / Height;
+
+                Uint32 NumVisible = 0;
+                for (Uint32 s = 0; s < NumSamples; ++s)
+                {
+                    // Uniform point on the light disc of radius 1.5 at (0, 4, 5)
+                    const float R   = 1.5f * std::sqrt(Rand(Rng));
+                    const float Phi = 6.2831853f * Rand(Rng);
+                    const float Lx  = R * std::cos(Phi);
+                    const float Lz  = 5.f + R * std::sin(Phi);
+
+                    // Does the segment from the floor point to the light hit the sphere of radius 1 at (0, 1.5, 5)?
+                    const float Dx = Lx - Px, Dy = 4.f, Dz = Lz - Pz;
+                    const float Ox = Px, Oy = -1.5f, Oz = Pz - 5.f;
+                    const float A  = Dx * Dx + Dy * Dy + Dz * Dz;
+                    const float B  = Ox * Dx + Oy * Dy + Oz * Dz;
+                    const float C  = Ox * Ox + Oy * Oy + Oz * Oz - 1.f;
+                    const float D  = B * B - A * C;
+                    const float T  = (-B - std::sqrt(std::max(D, 0.f))) / A;
+                    if (D < 0 || T < 0 || T > 1)
+                        ++NumVisible;
+                }
+
+                const float Visibility = static_cast<float>(NumVisible) / static_cast<float>(NumSamples);
+                pColor[0]              = 0.8f * Visibility;
+                pColor[1]              = 0.7f * Visibility;
+                pColor[2]              = 0.6f * Visibility;
+            }
+        }
+        return Color;
+    }
+};
+
+// The denoised 1-sample image must be much closer to the 16-sample reference than the noisy one.
+void TestDenoiserPSNR()
+{
+    const SoftShadowScene Scene;
+
+    const std::vector<float> Reference = Scene.Render(16, 1);
+    const std::vector<float> Noisy     = Scene.Render(1, 2);
+
+    DenoiseAttribs Attribs;
+    Attribs.Width    = SoftShadowScene::Width;
+    Attribs.Height   = SoftShadowScene::Height;
+    Attribs.pColor   = Noisy.data();
+    Attribs.pDepth   = Scene.Depth.data();
+    Attribs.pNormals = Scene.Normals.data();
+    // One visibility sample per pixel makes luminance jump by up to 0.7 between neighbors,
+    // so the color edge-stopping must be looser than the default. Three passes cover the penumbra.
+    Attribs.ColorSigma = 2.f;
+    Attribs.NumPasses  = 3;
+
+    std::vector<float> Denoised(Noisy.size());
+    std::vector<float> Scratch;
+    Attribs.pOutput = Denoised.data();
+    DenoiseATrous(Attribs, Scratch);
+
+    const double NoisyPSNR    = ComputePSNR(Noisy.data(), Reference.data(), Reference.size());
+    const double DenoisedPSNR = ComputePSNR(Denoised.data(), Reference.data(), Reference.size());
+    std::printf("  PSNR vs 16-sample reference: 1 sample %.2f dB, denoised %.2f dB\n", NoisyPSNR, DenoisedPSNR);
+    TUTORIAL21_CHECK(DenoisedPSNR > NoisyPSNR + 10.0);
+    TUTORIAL21_CHECK(DenoisedPSNR > 27.0);
+
+    // The wall is separated from the floor by normals and must not be blurred.
+    bool WallPreserved = true;
+    for (Uint32 y = 0; y < SoftShadowScene::Height; ++y)
+    {
+        const float* pColor = &Denoised[y * SoftShadowScene::Width * 4];
+        WallPreserved       = WallPreserved && std::abs(pColor[2] - 0.8f) < 1e-4f;
+    }
+    TUTORIAL21_CHECK(WallPreserved);
+
+    // The result must not depend on how rows are split between threads.
+    std::vector<float> SingleThreaded(Noisy.size());
+    Attribs.pOutput    = SingleThreaded.data();
+    Attribs.NumThreads = 1;
+    DenoiseATrous(Attribs, Scratch);
+    TUTORIAL21_CHECK(SingleThreaded == Denoised);
+}
+
+// Sobol points, with and without Owen scrambling, must be more uniform than random points.
+void TestSampleSequenceDiscrepancy()
+{
+    constexpr Uint32 NumTrials = 8;
+
+    std::mt19937                          Rng{7};
+    std::uniform_real_distribution<float> Rand{0.f, 1.f};
+
+    for (Uint32 NumPoints : {16u, 64u, 256u})
+    {
+        std::vector<float2> Points(NumPoints);
+
+        for (Uint32 i = 0; i < NumPoints; ++i)
+            Points[i] = float2{SampleSequence::ToUnitFloat(SampleSequence::Sobol(i, 0)), SampleSequence::ToUnitFloat(SampleSequence::Sobol(i, 1))};
+        const double SobolDiscrepancy = SampleSequence::ComputeL2StarDiscrepancy(Points.data(), NumPoints);
+
+        // Average over several seeds so that a lucky random set can't pass for a bad sequence.
+        double OwenDiscrepancy   = 0;
+        double RandomDiscrepancy = 0;
+        for (Uint32 Trial = 0; Trial < NumTrials; ++Trial)
+        {
+            const Uint32 Seed = SampleSequence::HashSeed(NumPoints, 0, Trial);
+            for (Uint32 i = 0; i < NumPoints; ++i)
+            {
+                Points[i] = float2{SampleSequence::ToUnitFloat(SampleSequence::OwenScramble(SampleSequence::Sobol(i, 0), Seed)),
+                                   SampleSequence::ToUnitFloat(SampleSequence::OwenScramble(SampleSequence::Sobol(i, 1), Seed ^ 0x9E3779B9u))};
+            }
+            OwenDiscrepancy += SampleSequence::ComputeL2StarDiscrepancy(Points.data(), NumPoints) / NumTrials;
+
+            for (float2& Point : Points)
+                Point = float2{Rand(Rng), Rand(Rng)};
+            RandomDiscrepancy += SampleSequence::ComputeL2StarDiscrepancy(Points.data(), NumPoints) / NumTrials;
+        }
+
+        std::printf("  %3u points: Sobol %.5f, Owen-scrambled Sobol %.5f, random %.5f\n", NumPoints, SobolDiscrepancy, OwenDiscrepancy, RandomDiscrepancy);
+        TUTORIAL21_CHECK(SobolDiscrepancy < RandomDiscrepancy);
+        TUTORIAL21_CHECK(OwenDiscrepancy < RandomDiscrepancy);
+    }
+}
+
+// Wall at z = 10 with a sphere in front of it, seen by a camera looking along +Z.
+// Stores the primary hit of every pixel in the layout of the surface buffer.
+struct TemporalReuseScene
+{
+    static constexpr Uint32 Width  = 96;
+    static constexpr Uint32 Height = 64;
+
+    enum HIT_TYPE : Uint8
+    {
+        HIT_TYPE_SKY = 0,
+        HIT_TYPE_WALL,
+        HIT_TYPE_SPHERE
+    };
+
+    static constexpr float WallZ         = 10.f;
+    static constexpr float WallHalfWidth = 6.f;
+    static constexpr float SphereRadius  = 1.f;
+    static const float3    SphereCenter;
+
+    float3   CameraPos;
+    float4x4 ViewProj;
+    float4x4 InvViewProj;
+
+    std::vector<float> Surface;
+    std::vector<Uint8> Hits;
+
+    explicit TemporalReuseScene(const float3& _CameraPos) :
+        CameraPos{_CameraPos},
+        ViewProj{float4x4::Translation(-_CameraPos) * float4x4::Projection(PI_F / 3.f, static_cast<float>(Width) / Height, 0.1f, 100.f, false)},
+        InvViewProj{ViewProj.Inverse()},
+        Surface(Width * Height * 4),
+        Hits(Width * Height)
+    {
+        for (Uint32 y = 0; y < Height; ++y)
+        {
+            for (Uint32 x = 0; x < Width; ++x)
+            {
+                const Uint32 Idx = y * Width + x;
+                const float2 UV{(static_cast<float>(x) + 0.5f) / Width, (static_cast<float>(y) + 0.5f) / Height};
+                const float3 Dir = Reprojection::GetPrimaryRayDirection(UV, CameraPos, InvViewProj);
+
+                float* pSurface = &Surface[Idx * 4];
+
+                const float SphereDist = IntersectSphere(CameraPos, Dir, SphereRadius);
+                if (SphereDist > 0)
+                {
+                    const float3 Normal = normalize(CameraPos + Dir * SphereDist - SphereCenter);
+                    pSurface[0]         = Normal.x;
+                    pSurface[1]         = Normal.y;
+                    pSurface[2]         = Normal.z;
+                    pSurface[3]         = SphereDist;
+                    Hits[Idx]           = HIT_TYPE_SPHERE;
+                    continue;
+                }
+
+                const float WallDist = (WallZ - CameraPos.z) / Dir.z;
+                if (std::abs(CameraPos.x + Dir.x * WallDist) < WallHalfWidth)
+                {
+                    pSurface[2] = -1.f;
+                    pSurface[3] = WallDist;
+                    Hits[Idx]   = HIT_TYPE_WALL;
+                }
+            }
+        }
+    }
+
+    // Returns the distance to the sphere with the given radius along the ray, or 0 if there is no hit.
+    static float IntersectSphere(const float3& Origin, const float3& Dir, float Radius)
+    {
+        const float3 Offset = Origin - SphereCenter;
+        const float  B      = dot(Offset, Dir);
+        const float  D      = B * B - dot(Offset, Offset) + Radius * Radius;
+        return D >= 0 ? std::max(-B - std::sqrt(D), 0.f) : 0.f;
+    }
+
+    // Returns true if the segment between the points passes through the sphere with the given radius.
+    static bool IsOccluded(const float3& From, const float3& To, float Radius)
+    {
+        const float Dist = IntersectSphere(From, normalize(To - From), Radius);
+        return Dist > 0 && Dist < length(To - From);
+    }
+
+    ReprojectHistoryAttribs GetReprojectAttribs(const TemporalReuseScene& Prev) const
+    {
+        ReprojectHistoryAttribs Attribs;
+        Attribs.Width         = Width;
+        Attribs.Height        = Height;
+        Attribs.CameraPos     = CameraPos;
+        Attribs.InvViewProj   = InvViewProj;
+        Attribs.PrevCameraPos = Prev.CameraPos;
+        Attribs.PrevViewProj  = Prev.ViewProj;
+        Attribs.pSurface      = Surface.data();
+        Attribs.pPrevSurface  = Prev.Surface.data();
+        return Attribs;
+    }
+};
+const float3 TemporalReuseScene::SphereCenter{0, 0, 6};
+
+// Reconstructing the primary hit of a pixel and projecting it back must return the pixel.
+void TestReprojectionRoundTrip()
+{
+    const float3   CameraPos{1.f, 2.f, -3.f};
+    const float3   Forward = normalize(float3{1.f, -0.3f, 2.f});
+    const float3   Right   = normalize(cross(float3{0, 1, 0}, Forward));
+    const float3   Up      = cross(Forward, Right);
+    const float4x4 ViewProj =
+        float4x4::Translation(-CameraPos) * float4x4::ViewFromBasis(Right, Up, Forward) * float4x4::Projection(PI_F / 4.f, 1.5f, 0.1f, 100.f, false);
+    const float4x4 InvViewProj = ViewProj.Inverse();
+
+    float MaxUVError       = 0;
+    float MaxDistanceError = 0;
+    for (float v : {0.01f, 0.3f, 0.5f, 0.99f})
+    {
+        for (float u : {0.01f, 0.25f, 0.5f, 0.8f, 0.99f})
+        {
+            const float2 UV{u, v};
+            for (float HitDistance : {0.5f, 7.f, 60.f})
+            {
+                const float3 WorldPos = Reprojection::ReconstructWorldPosition(UV, HitDistance, CameraPos, InvViewProj);
+                MaxDistanceError      = std::max(MaxDistanceError, std::abs(length(WorldPos - CameraPos) - HitDistance) / HitDistance);
+
+                float2 ProjectedUV;
+                TUTORIAL21_CHECK(Reprojection::ProjectToScreen(float4{WorldPos, 1}, ViewProj, ProjectedUV));
+                MaxUVError = std::max({MaxUVError, std::abs(ProjectedUV.x - UV.x), std::abs(ProjectedUV.y - UV.y)});
+            }
+
+            // Primary ray misses are reprojected as directions.
+            float2 ProjectedUV;
+            TUTORIAL21_CHECK(Reprojection::ProjectToScreen(float4{Reprojection::GetPrimaryRayDirection(UV, CameraPos, InvViewProj), 0}, ViewProj, ProjectedUV));
+            MaxUVError = std::max({MaxUVError, std::abs(ProjectedUV.x - UV.x), std::abs(ProjectedUV.y - UV.y)});
+        }
+    }
+    std::printf("  Max UV error %g, max relative distance error %g\n", MaxUVError, MaxDistanceError);
+    TUTORIAL21_CHECK(MaxUVError < 1e-4f);
+    TUTORIAL21_CHECK(MaxDistanceError < 1e-4f);
+
+    // Points behind the camera are rejected.
+    float2 ProjectedUV;
+    TUTORIAL21_CHECK(!Reprojection::ProjectToScreen(float4{CameraPos - Forward * 5.f, 1}, ViewProj, ProjectedUV));
+}
+
+// With a static camera every pixel, including the sky, reuses the history in place.
+void TestReprojectionStaticCamera()
+{
+    const TemporalReuseScene Scene{float3{0.5f, 0.f, 0.f}};
+
+    const std::vector<float> Color(Scene.Surface.size(), 1.f);
+    const std::vector<float> PrevColor(Scene.Surface.size(), 0.f);
+    std::vector<float>       Output(Color.size());
+    std::vector<float>       MotionVectors(TemporalReuseScene::Width * TemporalReuseScene::Height * 2, 1.f);
+
+    ReprojectHistoryAttribs Attribs = Scene.GetReprojectAttribs(Scene);
+    Attribs.pColor                  = Color.data();
+    Attribs.pPrevColor              = PrevColor.data();
+    Attribs.HistoryWeight           = 0.75f;
+    Attribs.pOutput                 = Output.data();
+    Attribs.pMotionVectors          = MotionVectors.data();
+
+    const Uint32 NumReused = ReprojectHistory(Attribs);
+    TUTORIAL21_CHECK(NumReused == TemporalReuseScene::Width * TemporalReuseScene::Height);
+    TUTORIAL21_CHECK(std::count(Scene.Hits.begin(), Scene.Hits.end(), TemporalReuseScene::HIT_TYPE_SKY) > 0);
+
+    float MaxError = 0;
+    for (float Value : Output)
+        MaxError = std::max(MaxError, std::abs(Value - 0.25f));
+    float MaxMotion = 0;
+    for (float Motion : MotionVectors)
+        MaxMotion = std::max(MaxMotion, std::abs(Motion));
+    TUTORIAL21_CHECK(MaxError < 1e-4f);
+    TUTORIAL21_CHECK(MaxMotion < 1e-5f);
+}
+
+// When the camera moves, the part of the wall that was hidden behind the sphere in the
+// previous frame must not reuse the history, while the rest of the wall must.
+void TestReprojectionDisocclusion()
+{
+    const TemporalReuseScene Prev{float3{0.f, 0.f, 0.f}};
+    const TemporalReuseScene Curr{float3{2.f, 0.f, 0.f}};
+
+    // The history is black, so reused pixels are darker than the current color.
+    const std::vector<float> Color(Curr.Surface.size(), 1.f);
+    const std::vector<float> PrevColor(Prev.Surface.size(), 0.f);
+    std::vector<float>       Output(Color.size());
+
+    ReprojectHistoryAttribs Attribs = Curr.GetReprojectAttribs(Prev);
+    Attribs.pColor                  = Color.data();
+    Attribs.pPrevColor              = PrevColor.data();
+    Attribs.HistoryWeight           = 0.5f;
+    Attribs.pOutput                 = Output.data();
+    ReprojectHistory(Attribs);
+
+    // The sphere is shrunk or grown by a couple of pixels so that the bilinear footprint
+    // of the reprojected point is entirely on one side of its silhouette.
+    static constexpr float InnerRadius = 0.8f * TemporalReuseScene::SphereRadius;
+    static constexpr float OuterRadius = 1.3f * TemporalReuseScene::SphereRadius;
+
+    Uint32 NumDisoccluded  = 0;
+    Uint32 NumVisible      = 0;
+    Uint32 NumWrongReuse   = 0;
+    Uint32 NumMissingReuse = 0;
+    for (Uint32 y = 0; y < TemporalReuseScene::Height; ++y)
+    {
+        for (Uint32 x = 0; x < TemporalReuseScene::Width; ++x)
+        {
+            const Uint32 Idx = y * TemporalReuseScene::Width + x;
+            if (Curr.Hits[Idx] != TemporalReuseScene::HIT_TYPE_WALL)
+                continue;
+
+            const float2 UV{(static_cast<float>(x) + 0.5f) / TemporalReuseScene::Width, (static_cast<float>(y) + 0.5f) / TemporalReuseScene::Height};
+            const float3 WorldPos = Reprojection::ReconstructWorldPosition(UV, Curr.Surface[Idx * 4 + 3], Curr.CameraPos, Curr.InvViewProj);
+            const bool   IsReused = Output[Idx * 4] < 0.75f;
+
+            if (TemporalReuseScene::IsOccluded(Prev.CameraPos, WorldPos, InnerRadius))
+            {
+                ++NumDisoccluded;
+                NumWrongReuse += IsReused ? 1 : 0;
+                continue;
+            }
+
+            float2 PrevUV;
+            if (TemporalReuseScene::IsOccluded(Prev.CameraPos, WorldPos, OuterRadius) ||
+                !Reprojection::ProjectToScreen(float4{WorldPos, 1}, Prev.ViewProj, PrevUV) ||
+                std::min(PrevUV.x, PrevUV.y) < 0.05f || std::max(PrevUV.x, PrevUV.y) > 0.95f ||
+                std::abs(WorldPos.x) > TemporalReuseScene::WallHalfWidth - 1.f)
+                continue;
+
+            ++NumVisible;
+            NumMissingReuse += IsReused ? 0 : 1;
+        }
+    }
+    std::printf("  %u disoccluded and %u visible wall pixels\n", NumDisoccluded, NumVisible);
+    TUTORIAL21_CHECK(NumDisoccluded > 20);
+    TUTORIAL21_CHECK(NumVisible > 1000);
+    TUTORIAL21_CHECK(NumWrongReuse == 0);
+    TUTORIAL21_CHECK(NumMissingReuse == 0);
+}
+
+// Primary rays of every cubemap face view must land on the same face and texel when
+// the traced slices are sampled as a cubemap, and every direction must be covered by its face.
+void TestMultiViewCubemap()
+{
+    const float3 Position{1.f, 2.f, 3.f};
+
+    std::mt19937                          Rng{11};
+    std::uniform_real_distribution<float> Rand{-1.f, 1.f};
+
+    for (bool IsGL : {false, true})
+    {
+        MultiViewCamera  Views[CUBEMAP_FACE_COUNT];
+        MultiViewAttribs Attribs[CUBEMAP_FACE_COUNT];
+        GetCubemapViews(Position, 0.1f, 100.f, IsGL, Views);
+        WriteMultiViewAttribs(Views, CUBEMAP_FACE_COUNT, Attribs);
+
+        Uint32 NumWrongFaces = 0;
+        float  MaxUVError    = 0;
+        for (Uint32 Face = 0; Face < CUBEMAP_FACE_COUNT; ++Face)
+        {
+            TUTORIAL21_CHECK(Attribs[Face].CameraPos.x == Position.x && Attribs[Face].CameraPos.y == Position.y && Attribs[Face].CameraPos.z == Position.z);
+
+            for (float v : {0.02f, 0.3f, 0.5f, 0.7f, 0.98f})
+            {
+                for (float u : {0.02f, 0.3f, 0.5f, 0.7f, 0.98f})
+                {
+                    const float2 UV{u, v};
+                    const float3 Dir = Reprojection::GetPrimaryRayDirection(UV, Position, Attribs[Face].InvViewProj);
+
+                    float2 FaceUV;
+                    NumWrongFaces += GetCubemapFace(Dir, FaceUV) != Face ? 1 : 0;
+                    MaxUVError = std::max({MaxUVError, std::abs(FaceUV.x - UV.x), std::abs(FaceUV.y - UV.y)});
+                }
+            }
+        }
+
+        for (Uint32 i = 0; i < 1000; ++i)
+        {
+            const float3       Dir{Rand(Rng), Rand(Rng), Rand(Rng)};
+            float2             FaceUV;
+            const CUBEMAP_FACE Face = GetCubemapFace(Dir, FaceUV);
+
+            float2 ProjectedUV;
+            if (!Reprojection::ProjectToScreen(float4{Dir, 0}, Views[Face].View * Views[Face].Proj, ProjectedUV))
+                ++NumWrongFaces;
+            MaxUVError = std::max({MaxUVError, std::abs(FaceUV.x - ProjectedUV.x), std::abs(FaceUV.y - ProjectedUV.y)});
+        }
+
+        std::printf("  %s: %u wrong faces, max UV error %g\n", IsGL ? "GL" : "D3D", NumWrongFaces, MaxUVError);
+        TUTORIAL21_CHECK(NumWrongFaces == 0);
+        TUTORIAL21_CHECK(MaxUVError < 1e-4f);
+    }
+}
+
+// Stereo eyes must be centered on the camera, separated along its right axis and keep its orientation.
+void TestMultiViewStereo()
+{
+    const float3   CameraPos{-2.f, 1.f, 4.f};
+    const float3   Forward = normalize(float3{-1.f, 0.2f, 0.5f});
+    const float3   Right   = normalize(cross(float3{0, 1, 0}, Forward));
+    const float3   Up      = cross(Forward, Right);
+    const float4x4 View    = float4x4::Translation(-CameraPos) * float4x4::ViewFromBasis(Right, Up, Forward);
+    const float4x4 Proj    = float4x4::Projection(PI_F / 4.f, 1.5f, 0.1f, 100.f, false);
+
+    constexpr float EyeSeparation = 0.064f;
+
+    MultiViewCamera Eyes[2];
+    GetStereoViews(View, Proj, EyeSeparation, Eyes);
+
+    const float3 Center = (Eyes[0].Position + Eyes[1].Position) * 0.5f;
+    const float3 Offset = Eyes[1].Position - Eyes[0].Position;
+    TUTORIAL21_CHECK(length(Center - CameraPos) < 1e-5f);
+    TUTORIAL21_CHECK(std::abs(dot(Offset, Right) - EyeSeparation) < 1e-5f);
+    TUTORIAL21_CHECK(std::abs(length(Offset) - EyeSeparation) < 1e-5f);
+
+    for (const MultiViewCamera& Eye : Eyes)
+    {
+        // The eye is at the origin of its view space.
+        const float4 EyeViewPos = float4{Eye.Position, 1} * Eye.View;
+        TUTORIAL21_CHECK(std::max({std::abs(EyeViewPos.x), std::abs(EyeViewPos.y), std::abs(EyeViewPos.z)}) < 1e-5f);
+
+        // Parallel stereo: directions are transformed exactly as by the camera.
+        for (const float3& Dir : {Right, Up, Forward, normalize(float3{1.f, 2.f, 3.f})})
+        {
+            const float4 EyeDir    = float4{Dir, 0} * Eye.View;
+            const float4 CameraDir = float4{Dir, 0} * View;
+            TUTORIAL21_CHECK(std::max({std::abs(EyeDir.x - CameraDir.x), std::abs(EyeDir.y - CameraDir.y), std::abs(EyeDir.z - CameraDir.z)}) < 1e-5f);
+        }
+    }
+}
+
+std::vector<LightAttribs> MakeTestLights(Uint32 NumLights, Uint32 Seed)
+{
+    std::mt19937                          Rng{Seed};
+    std::uniform_real_distribution<float> Rand{0.f, 1.f};
+
+    std::vector<LightAttribs> Lights(NumLights);
+    for (LightAttribs& Light : Lights)
+    {
+        Light.Position  = float3{Rand(Rng) * 40.f - 20.f, Rand(Rng) * 10.f, Rand(Rng) * 40.f - 20.f};
+        Light.Radius    = Rand(Rng) * 0.5f;
+        Light.Color     = float3{Rand(Rng), Rand(Rng), Rand(Rng)};
+        Light.Intensity = 0.5f + Rand(Rng) * 4.f;
+    }
+    return Lights;
+}
+
+// Returns the probability of reaching the leaf of LightIdx as the product of the branch
+// probabilities along its path, independently of the traversal in SampleLight().
+float GetLightSelectionProbability(const std::vector<LightBVHNode>& Nodes, Uint32 LightIdx, const float3& Position)
+{
+    std::vector<Uint32> Parents(Nodes.size(), ~0u);
+    Uint32              LeafIdx = ~0u;
+    for (Uint32 i = 0; i < Nodes.size(); ++i)
+    {
+        if ((Nodes[i].ChildOrLight & LIGHT_BVH_LEAF_FLAG) == 0)
+        {
+            Parents[i + 1]                 = i;
+            Parents[Nodes[i].ChildOrLight] = i;
+        }
+        else if ((Nodes[i].ChildOrLight & ~LIGHT_BVH_LEAF_FLAG) == LightIdx)
+        {
+            LeafIdx = i;
+        }
+    }
+    if (LeafIdx == ~0u)
+        return -1;
+
+    float Probability = 1;
+    for (Uint32 NodeIdx = LeafIdx; Parents[NodeIdx] != ~0u; NodeIdx = Parents[NodeIdx])
+    {
+        const Uint32 Parent      = Parents[NodeIdx];
+        const float  ImportanceL = LightBVH::GetNodeImportance(Nodes[Parent + 1], Position);
+        const float  ImportanceR = LightBVH::GetNodeImportance(Nodes[Nodes[Parent].ChildOrLight], Position);
+        const float  Total       = ImportanceL + ImportanceR;
+        const float  ProbL       = Total > 0 ? ImportanceL / Total : 0.5f;
+        Probability *= NodeIdx == Parent + 1 ? ProbL : 1.f - ProbL;
+    }
+    return Probability;
+}
+
+// The parallel build must produce the same tree as the single-threaded one, with every light in exactly one leaf.
+void TestLightBVHBuild()
+{
+    // Large enough for the top levels to be split into parallel subtrees.
+    constexpr Uint32 NumLights = 20000;
+
+    const std::vector<LightAttribs> Lights = MakeTestLights(NumLights, 3);
+
+    LightBVH SerialBVH;
+    SerialBVH.Build(Lights.data(), NumLights, 1);
+    const std::vector<LightBVHNode>& SerialNodes = SerialBVH.GetNodes();
+
+    // The split depends on the requested thread count only, so this runs the parallel path on any machine.
+    // A separate tree makes sure that no node is left over from the serial build.
+    LightBVH ParallelBVH;
+    ParallelBVH.Build(Lights.data(), NumLights, 8);
+    const std::vector<LightBVHNode>& ParallelNodes = ParallelBVH.GetNodes();
+
+    TUTORIAL21_CHECK(SerialNodes.size() == NumLights * 2 - 1);
+    TUTORIAL21_CHECK(ParallelNodes.size() == SerialNodes.size() &&
+                     std::memcmp(ParallelNodes.data(), SerialNodes.data(), SerialNodes.size() * sizeof(LightBVHNode)) == 0);
+
+    std::vector<Uint32> LeafCount(NumLights);
+    bool                BoundsValid = true;
+    for (Uint32 i = 0; i < ParallelNodes.size(); ++i)
+    {
+        const LightBVHNode& Node = ParallelNodes[i];
+        if ((Node.ChildOrLight & LIGHT_BVH_LEAF_FLAG) != 0)
+        {
+            const Uint32 LightIdx = Node.ChildOrLight & ~LIGHT_BVH_LEAF_FLAG;
+            if (LightIdx < NumLights)
+                ++LeafCount[LightIdx];
+            continue;
+        }
+
+        // Inner nodes enclose both children and sum their power.
+        for (const LightBVHNode* pChild : {&ParallelNodes[i + 1], &ParallelNodes[Node.ChildOrLight]})
+        {
+            BoundsValid = BoundsValid &&
+                Node.BoundsMin.x <= pChild->BoundsMin.x && Node.BoundsMin.y <= pChild->BoundsMin.y && Node.BoundsMin.z <= pChild->BoundsMin.z &&
+                Node.BoundsMax.x >= pChild->BoundsMax.x && Node.BoundsMax.y >= pChild->BoundsMax.y && Node.BoundsMax.z >= pChild->BoundsMax.z;
+        }
+        BoundsValid = BoundsValid && std::abs(Node.Power - ParallelNodes[i + 1].Power - ParallelNodes[Node.ChildOrLight].Power) <= 1e-4f * Node.Power;
+    }
+    TUTORIAL21_CHECK(std::all_of(LeafCount.begin(), LeafCount.end(), [](Uint32 Count) { return Count == 1; }));
+    TUTORIAL21_CHECK(BoundsValid);
+}
+
+// Pdf returned by SampleLight() must be the product of the branch probabilities, and lights
+// must be selected with that frequency. Zero-power lights must never be selected.
+void TestLightBVHSample()
+{
+    constexpr Uint32 NumLights  = 37;
+    constexpr Uint32 NumSamples = 1 << 16;
+
+    std::vector<LightAttribs> Lights = MakeTestLights(NumLights, 5);
+    Lights[11].Intensity             = 0;
+
+    LightBVH BVH;
+    BVH.Build(Lights.data(), NumLights);
+
+    for (const float3& Position : {float3{0.f, 1.f, 0.f}, float3{15.f, 2.f, -8.f}})
+    {
+        std::vector<Uint32> Histogram(NumLights);
+        float               MaxPdfError  = 0;
+        bool                IndicesValid = true;
+        for (Uint32 i = 0; i < NumSamples; ++i)
+        {
+            // Stratified random numbers make the frequencies converge quickly.
+            float        Pdf      = 0;
+            const Uint32 LightIdx = BVH.SampleLight(Position, (static_cast<float>(i) + 0.5f) / NumSamples, Pdf);
+            if (LightIdx >= NumLights)
+            {
+                IndicesValid = false;
+                continue;
+            }
+            ++Histogram[LightIdx];
+
+            const float Expected = GetLightSelectionProbability(BVH.GetNodes(), LightIdx, Position);
+            MaxPdfError          = std::max(MaxPdfError, std::abs(Pdf - Expected) / Expected);
+        }
+
+        float MaxFrequencyError = 0;
+        float TotalProbability  = 0;
+        for (Uint32 LightIdx = 0; LightIdx < NumLights; ++LightIdx)
+        {
+            const float Probability = GetLightSelectionProbability(BVH.GetNodes(), LightIdx, Position);
+            const float Frequency   = static_cast<float>(Histogram[LightIdx]) / NumSamples;
+            MaxFrequencyError       = std::max(MaxFrequencyError, std::abs(Frequency - Probability));
+            TotalProbability += Probability;
+        }
+
+        std::printf("  Max relative pdf error %g, max frequency error %g\n", MaxPdfError, MaxFrequencyError);
+        TUTORIAL21_CHECK(IndicesValid);
+        TUTORIAL21_CHECK(MaxPdfError < 1e-4f);
+        TUTORIAL21_CHECK(MaxFrequencyError < 1e-3f);
+        TUTORIAL21_CHECK(std::abs(TotalProbability - 1.f) < 1e-4f);
+        TUTORIAL21_CHECK(Histogram[11] == 0);
+    }
+
+    // A single light is a leaf root that is always selected.
+    float Pdf = 0;
+    BVH.Build(Lights.data(), 1);
+    TUTORIAL21_CHECK(BVH.GetNodes().size() == 1);
+    TUTORIAL21_CHECK(BVH.SampleLight(float3{0, 0, 0}, 0.7f, Pdf) == 0 && Pdf == 1.f);
+
+    // Nothing can be selected if no light emits.
+    for (LightAttribs& Light : Lights)
+        Light.Intensity = 0;
+    BVH.Build(Lights.data(), NumLights);
+    TUTORIAL21_CHECK(BVH.SampleLight(float3{0, 0, 0}, 0.3f, Pdf) == ~0u && Pdf == 0.f);
+
+    BVH.Build(Lights.data(), 0);
+    TUTORIAL21_CHECK(BVH.SampleLight(float3{0, 0, 0}, 0.3f, Pdf) == ~0u && Pdf == 0.f);
+}
+
+struct TestCase
+{
+    const char* Name;
+    void (*Run)();
+};
+
+// clang-format off
+const TestCase TestCases[] =
+{
+    {"EncodeFrame.Raw",            TestEncodeFrameRaw},
+    {"EncodeFrame.PNG",            TestEncodeFramePNG},
+    {"EncodeFrame.EXR",            TestEncodeFrameEXR},
+    {"FrameEncodeQueue",           TestFrameEncodeQueue},
+    {"WorkerPool",                 TestWorkerPool},
+    {"Denoiser.PSNR",              TestDenoiserPSNR},
+    {"SampleSequence.Discrepancy", TestSampleSequenceDiscrepancy},
+    {"Reprojection.RoundTrip",     TestReprojectionRoundTrip},
+    {"Reprojection.StaticCamera",  TestReprojectionStaticCamera},
+    {"Reprojection.Disocclusion",  TestReprojectionDisocclusion},
+    {"MultiView.Cubemap",          TestMultiViewCubemap},
+    {"MultiView.Stereo",           TestMultiViewStereo},
+    {"LightBVH.Build",             TestLightBVHBuild},
+    {"LightBVH.Sample",            TestLightBVHSample},
+};
+// clang-format on
+
+} // namespace
+
+} // namespace Diligent
+
+int main(int argc, char** argv)
+{
+    using namespace Diligent;
+
+    const char* Filter = argc > 1 ? argv[1] : "";
+
+    Uint32 NumRun    = 0;
+    Uint32 NumFailed = 0;
+    for (const TestCase& Test : TestCases)
+    {
+        if (std::strstr(Test.Name, Filter) == nullptr)
+            continue;
+
+        const Uint32 NumFailedChecks = g_NumFailedChecks;
+        Test.Run();
+        const bool Passed = g_NumFailedChecks == NumFailedChecks;
+        std::printf("%-32s %s\n", Test.Name, Passed ? "OK" : "FAILED");
+
+        ++NumRun;
+        if (!Passed)
+            ++NumFailed;
+    }
+
+    std::printf("\n%u test(s) run, %u failed\n", NumRun, NumFailed);
+    return NumFailed == 0 && NumRun > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
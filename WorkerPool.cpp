@@ -0,0 +1,139 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+
+namespace Diligent
+{
+
+namespace
+{
+
+// The pool whose loop the current thread is executing, if any.
+thread_local const WorkerPool* t_pActivePool = nullptr;
+
+} // namespace
+
+WorkerPool::WorkerPool(Uint32 NumThreads)
+{
+    if (NumThreads == 0)
+        NumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    m_Workers.reserve(NumThreads - 1);
+    for (Uint32 i = 1; i < NumThreads; ++i)
+        m_Workers.emplace_back(&WorkerPool::WorkerThread, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_Stop = true;
+    }
+    m_WorkCV.notify_all();
+    for (std::thread& Worker : m_Workers)
+        Worker.join();
+}
+
+WorkerPool& WorkerPool::GetDefault()
+{
+    static WorkerPool DefaultPool;
+    return DefaultPool;
+}
+
+void WorkerPool::Dispatch(Uint32 NumItems, Uint32 NumChunks, RangeFuncType Func, const void* pFn)
+{
+    if (NumItems == 0)
+        return;
+
+    if (NumChunks == 0)
+        NumChunks = GetNumThreads() * 4;
+    NumChunks = std::min(NumChunks, NumItems);
+
+    if (NumChunks == 1 || m_Workers.empty() || t_pActivePool == this)
+    {
+        Func(pFn, 0, NumItems);
+        return;
+    }
+
+    std::lock_guard<std::mutex> DispatchLock{m_DispatchMtx};
+    {
+        std::unique_lock<std::mutex> Lock{m_Mtx};
+        // A worker that woke up late for the previous loop may still be looking for chunks.
+        m_DoneCV.wait(Lock, [this]() { return m_NumBusyWorkers == 0; });
+
+        m_Func      = Func;
+        m_pFn       = pFn;
+        m_NumItems  = NumItems;
+        m_NumChunks = NumChunks;
+        m_NextChunk.store(0);
+        ++m_Generation;
+    }
+    m_WorkCV.notify_all();
+
+    t_pActivePool = this;
+    RunChunks();
+    t_pActivePool = nullptr;
+
+    std::unique_lock<std::mutex> Lock{m_Mtx};
+    m_DoneCV.wait(Lock, [this]() { return m_NumBusyWorkers == 0; });
+}
+
+void WorkerPool::RunChunks()
+{
+    while (true)
+    {
+        const Uint32 Chunk = m_NextChunk.fetch_add(1);
+        if (Chunk >= m_NumChunks)
+            break;
+
+        // Spread the remainder over the first chunks so that chunk sizes differ by at most one.
+        const Uint32 First = static_cast<Uint32>(Uint64{m_NumItems} * Chunk / m_NumChunks);
+        const Uint32 End   = static_cast<Uint32>(Uint64{m_NumItems} * (Chunk + 1) / m_NumChunks);
+        m_Func(m_pFn, First, End);
+    }
+}
+
+void WorkerPool::WorkerThread()
+{
+    t_pActivePool = this;
+
+    Uint64 LastGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> Lock{m_Mtx};
+            m_WorkCV.wait(Lock, [&]() { return m_Stop || m_Generation != LastGeneration; });
+            if (m_Stop)
+                return;
+            LastGeneration = m_Generation;
+            ++m_NumBusyWorkers;
+        }
+
+        RunChunks();
+
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+            --m_NumBusyWorkers;
+        }
+        m_DoneCV.notify_all();
+    }
+}
+
+} // namespace Diligent
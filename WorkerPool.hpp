@@ -0,0 +1,106 @@
+/*
+ *  Copyright 2019-2025 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Pool of persistent worker threads for data-parallel loops.
+///
+/// Unlike spawning threads for every loop, dispatching work to the pool neither creates
+/// threads nor allocates memory, so it can be used on the frame path.
+class WorkerPool
+{
+public:
+    /// Creates a pool that runs loops on NumThreads threads including the calling one
+    /// (0 means std::thread::hardware_concurrency()).
+    explicit WorkerPool(Uint32 NumThreads = 0);
+    ~WorkerPool();
+
+    // clang-format off
+    WorkerPool(const WorkerPool&)            = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    // clang-format on
+
+    /// Returns the process-wide pool with one thread per hardware thread.
+    static WorkerPool& GetDefault();
+
+    Uint32 GetNumThreads() const { return static_cast<Uint32>(m_Workers.size()) + 1; }
+
+    /// Calls Fn(First, End) for disjoint ranges that cover [0, NumItems) and blocks until all
+    /// of them are processed. The range is split into NumChunks chunks (0 means four per thread),
+    /// which also limits the number of threads that take part. The calling thread processes
+    /// chunks too. Calls from inside a loop of the same pool run serially on the calling thread.
+    template <typename FnType>
+    void ParallelFor(Uint32 NumItems, const FnType& Fn, Uint32 NumChunks = 0)
+    {
+        Dispatch(NumItems, NumChunks, &InvokeRange<FnType>, &Fn);
+    }
+
+private:
+    using RangeFuncType = void (*)(const void* pFn, Uint32 First, Uint32 End);
+
+    template <typename FnType>
+    static void InvokeRange(const void* pFn, Uint32 First, Uint32 End)
+    {
+        (*static_cast<const FnType*>(pFn))(First, End);
+    }
+
+    void Dispatch(Uint32 NumItems, Uint32 NumChunks, RangeFuncType Func, const void* pFn);
+    void RunChunks();
+    void WorkerThread();
+
+    // Serializes loops started from different threads.
+    std::mutex m_DispatchMtx;
+
+    std::mutex              m_Mtx;
+    std::condition_variable m_WorkCV;
+    std::condition_variable m_DoneCV;
+    Uint64                  m_Generation     = 0;
+    Uint32                  m_NumBusyWorkers = 0;
+    bool                    m_Stop           = false;
+
+    // The current loop. Only changes while no worker is busy.
+    RangeFuncType       m_Func      = nullptr;
+    const void*         m_pFn       = nullptr;
+    Uint32              m_NumItems  = 0;
+    Uint32              m_NumChunks = 0;
+    std::atomic<Uint32> m_NextChunk{0};
+
+    std::vector<std::thread> m_Workers;
+};
+
+} // namespace Diligent